@@ -0,0 +1,121 @@
+#ifndef BHAVESH_MATRIX_BATCHED_H
+#define BHAVESH_MATRIX_BATCHED_H 0.1
+
+#include "bhavesh_matrix_fixed.h"
+
+namespace bhavesh {
+
+	inline namespace detail {
+	namespace batched_detail {
+		// products handled together by one interleaved group: a 64 byte register worth of T
+		template <typename T>
+		constexpr std::size_t lanes = sizeof(T) < 64 ? 64 / sizeof(T) : 1;
+
+		// narrow results (a row of C smaller than a 32 byte register) gain nothing from vectorizing inside one product, so those
+		// shapes are vectorized across the batch instead, as long as the interleaved operands stay a reasonable stack footprint
+		template <typename T, std::size_t M, std::size_t K, std::size_t N>
+		constexpr bool interleave = std::is_arithmetic_v<T> && !std::is_same_v<T, bool> && N * sizeof(T) < 32 &&
+			(M * K + K * N) * lanes<T> * sizeof(T) <= (std::size_t(64) << 10);
+
+		// up to lanes<T> products at once; element e of product l sits at [e][l], so every multiply-add below is one operation across the batch
+		template <typename T, std::size_t M, std::size_t K, std::size_t N>
+		inline void interleaved_group(const T* a, const T* b, T* c, std::size_t count) {
+			constexpr std::size_t W = lanes<T>;
+			alignas(64) T ai[M * K][W];
+			alignas(64) T bi[K * N][W];
+			for (std::size_t e = 0; e != M * K; ++e) {
+				for (std::size_t l = 0; l != W; ++l) ai[e][l] = l < count ? a[l * M * K + e] : T{};
+			}
+			for (std::size_t e = 0; e != K * N; ++e) {
+				for (std::size_t l = 0; l != W; ++l) bi[e][l] = l < count ? b[l * K * N + e] : T{};
+			}
+			for (std::size_t i = 0; i != M; ++i) {
+				for (std::size_t j = 0; j != N; ++j) {
+					alignas(64) T acc[W] = {};
+					for (std::size_t p = 0; p != K; ++p) {
+						for (std::size_t l = 0; l != W; ++l) acc[l] += ai[i * K + p][l] * bi[p * N + j][l];
+					}
+					for (std::size_t l = 0; l != count; ++l) c[l * M * N + i * N + j] = acc[l];
+				}
+			}
+		}
+
+		// one product, a row of C at a time; with compile time extents the j loop is a fixed length vector loop
+		template <typename T, std::size_t M, std::size_t K, std::size_t N>
+		inline void row_product(const T* a, const T* b, T* c) {
+			for (std::size_t i = 0; i != M; ++i) {
+				T row[N] = {};
+				for (std::size_t p = 0; p != K; ++p) {
+					const T x = a[i * K + p];
+					for (std::size_t j = 0; j != N; ++j) row[j] = row[j] + x * b[p * N + j];
+				}
+				for (std::size_t j = 0; j != N; ++j) c[i * N + j] = row[j];
+			}
+		}
+
+		template <typename T>
+		inline void row_product(std::size_t m, std::size_t k, std::size_t n, const T* a, const T* b, T* c) {
+			for (std::size_t i = 0; i != m; ++i) {
+				T* row = c + i * n;
+				for (std::size_t j = 0; j != n; ++j) row[j] = T{};
+				for (std::size_t p = 0; p != k; ++p) {
+					const T x = a[i * k + p];
+					for (std::size_t j = 0; j != n; ++j) row[j] = row[j] + x * b[p * n + j];
+				}
+			}
+		}
+
+		template <typename T, std::size_t M, std::size_t K, std::size_t N>
+		void run(std::size_t count, const T* a, const T* b, T* c) {
+			sched_detail::for_ranges<T>(count, [a, b, c](std::size_t first, std::size_t last) {
+				if constexpr (interleave<T, M, K, N>) {
+					for (std::size_t g = first; g < last; g += lanes<T>) {
+						interleaved_group<T, M, K, N>(a + g * M * K, b + g * K * N, c + g * M * N, std::min(lanes<T>, last - g));
+					}
+				}
+				else {
+					for (std::size_t g = first; g != last; ++g) row_product<T, M, K, N>(a + g * M * K, b + g * K * N, c + g * M * N);
+				}
+			}, M * K * N);
+		}
+
+		// square shapes that get a kernel of their own when the shape is only known at runtime
+		template <typename T, std::size_t... S>
+		inline bool run_square(std::size_t count, std::size_t s, const T* a, const T* b, T* c, std::index_sequence<S...>) {
+			return ((s == S ? (run<T, S, S, S>(count, a, b, c), true) : false) || ...);
+		}
+	}
+	}
+
+	/*
+	 * count independent products c[i] = a[i] * b[i] of equally shaped small matrices, each operand array packed back to back in row-major order
+	 * (a holds count M x K matrices, b count K x N, c count M x N and is fully overwritten; c must not overlap a or b)
+	 * no allocation and no per product checks; kernels are instantiated per shape, narrow shapes vectorize across the batch and
+	 * the batch is spread over matrix_scheduler's pool once it is large enough
+	 */
+	template <std::size_t M, std::size_t K, std::size_t N, typename T>
+	void batched_mul(std::size_t count, const T* a, const T* b, T* c) {
+		static_assert(M != 0 && K != 0 && N != 0, "batched_mul needs non-zero extents");
+		batched_detail::run<T, M, K, N>(count, a, b, c);
+	}
+
+	// extents known only at runtime: square 2..8, 16 and 32 dispatch to their own kernels, anything else takes a generic loop
+	template <typename T>
+	void batched_mul(std::size_t count, std::size_t m, std::size_t k, std::size_t n, const T* a, const T* b, T* c) {
+		if (count == 0 || m == 0 || n == 0) return;
+		if (m == k && k == n && batched_detail::run_square<T>(count, m, a, b, c, std::index_sequence<2, 3, 4, 5, 6, 7, 8, 16, 32>{})) return;
+		sched_detail::for_ranges<T>(count, [=](std::size_t first, std::size_t last) {
+			for (std::size_t g = first; g != last; ++g) batched_detail::row_product(m, k, n, a + g * m * k, b + g * k * n, c + g * m * n);
+		}, m * k * n);
+	}
+
+	template <typename T, std::size_t M, std::size_t K, std::size_t N>
+	void batched_mul(std::size_t count, const fixed_matrix<T, M, K>* a, const fixed_matrix<T, K, N>* b, fixed_matrix<T, M, N>* c) {
+		static_assert(sizeof(fixed_matrix<T, M, K>) == M * K * sizeof(T) && sizeof(fixed_matrix<T, M, N>) == M * N * sizeof(T), "fixed_matrix arrays are expected to be packed");
+		if (count == 0) return;
+		batched_detail::run<T, M, K, N>(count, a->data(), b->data(), c->data());
+	}
+
+}
+
+#endif // !BHAVESH_MATRIX_BATCHED_H
@@ -0,0 +1,327 @@
+#ifndef BHAVESH_MATRIX_FIXED_H
+#define BHAVESH_MATRIX_FIXED_H 0.1
+
+#include "bhavesh_matrix_v1.h"
+
+#ifndef BHAVESH_FIXED_MATRIX_UNROLL_LIMIT
+# define BHAVESH_FIXED_MATRIX_UNROLL_LIMIT 256 // element count above which operations are written as loops instead of unrolled folds
+#endif
+
+namespace bhavesh {
+
+	inline namespace detail {
+	namespace fixed_detail {
+		// out[I] = f(I) for every I; a fold over an index_sequence for small sizes so every element is its own statement
+		template <typename F, std::size_t... I>
+		constexpr void unrolled(F&& f, std::index_sequence<I...>) {
+			(f(std::integral_constant<std::size_t, I>{}), ...);
+		}
+
+		template <std::size_t S, typename F>
+		constexpr void for_each_index(F&& f) {
+			if constexpr (S <= BHAVESH_FIXED_MATRIX_UNROLL_LIMIT) {
+				unrolled(std::forward<F>(f), std::make_index_sequence<S>{});
+			}
+			else {
+				for (std::size_t i = 0; i != S; ++i) f(i);
+			}
+		}
+
+		// sum over k of a[i, k] * b[k, j] for compile time inner dimension
+		template <typename To, std::size_t N, std::size_t P, typename A, typename B, std::size_t... K>
+		constexpr To dot(const A* a, const B* b, std::size_t i, std::size_t j, std::index_sequence<K...>) {
+			return (To{} + ... + static_cast<To>(a[i * N + K] * b[K * P + j]));
+		}
+
+		// f(a, b) elementwise for a fixed and a dynamic operand (either way round); the shape is checked at runtime, the result is dynamic
+		template <typename To, typename Alloc, typename A, typename B, typename F>
+		BHAVESH_CXX20_CONSTEXPR matrix<To, Alloc> zip_dynamic(const A& a, const B& b, F f, const char* mismatch) {
+			if (a.shape() != b.shape()) throw std::invalid_argument(mismatch);
+			const std::size_t s = a.shape().first * a.shape().second;
+			matrix_detail::construction_holder<To, Alloc> h(s);
+			for (std::size_t i = 0; i != s; ++i) h.emplace_back(f(a._get(i), b._get(i)));
+			return matrix<To, Alloc>(matrix_take_ownership, h.release<true>(), a.shape().first, a.shape().second);
+		}
+	}
+	}
+
+	/*
+	 * statically sized sibling of matrix<T>: extents are template arguments and the elements live inline (no allocation, no indirection)
+	 * intended for small shapes (3x3/4x4 transforms); arithmetic is unrolled up to BHAVESH_FIXED_MATRIX_UNROLL_LIMIT elements
+	 * accessors mirror matrix<T> (operator[] -> matrix_row, operator(), get, shape), so generic code can take either
+	 * converts to and from matrix<T, Alloc>; the dynamic -> fixed direction checks the shape at runtime
+	 */
+	template <typename T, std::size_t M, std::size_t N>
+	class fixed_matrix {
+	public:
+		static_assert(M != 0 && N != 0, "fixed_matrix needs non-zero extents");
+		static_assert(!std::is_reference_v<T>, "matrix of reference type is ill-defined");
+		static_assert(!std::is_const_v<T>, "matrix<const T> is ill-defined; use const matrix<T> instead");
+
+		using value_type = T;
+		static constexpr std::size_t rows = M;
+		static constexpr std::size_t cols = N;
+
+	public: /* constructors */
+		constexpr fixed_matrix() : m_data{} {}
+		constexpr explicit fixed_matrix(const T& v) : m_data{} {
+			for (std::size_t i = 0; i != M * N; ++i) m_data[i] = v;
+		}
+
+		// the list must fill every element, as for matrix(m, n, { ... }); in a constant expression a wrong size fails to compile
+		constexpr fixed_matrix(std::initializer_list<T> il) : m_data{} {
+			if (il.size() < M * N) throw std::invalid_argument( "too few arguments given to fixed_matrix{ ... }");
+			if (il.size() > M * N) throw std::invalid_argument("too many arguments given to fixed_matrix{ ... }");
+			std::size_t i = 0;
+			for (const T& v : il) m_data[i++] = v;
+		}
+		constexpr fixed_matrix(std::initializer_list<std::initializer_list<T>> il) : m_data{} {
+			if (il.size() < M) throw std::invalid_argument( "too few arguments given to fixed_matrix{ ... }");
+			if (il.size() > M) throw std::invalid_argument("too many arguments given to fixed_matrix{ ... }");
+			std::size_t i = 0;
+			for (const auto& row : il) {
+				if (row.size() < N) throw std::invalid_argument( "too few arguments given to fixed_matrix{ ... }");
+				if (row.size() > N) throw std::invalid_argument("too many arguments given to fixed_matrix{ ... }");
+				std::size_t j = 0;
+				for (const T& v : row) m_data[i * N + j++] = v;
+				++i;
+			}
+		}
+
+		template <typename Alloc>
+		BHAVESH_CXX20_CONSTEXPR explicit fixed_matrix(const matrix<T, Alloc>& mat) : m_data{} {
+			if (mat.shape() != shape()) throw std::invalid_argument("Shape mismatch converting matrix to fixed_matrix");
+			for (std::size_t i = 0; i != M * N; ++i) m_data[i] = mat._get(i);
+		}
+
+	public: /* conversion into the dynamic matrix */
+		template <typename Alloc = BHAVESH_MATRIX_DEFAULT_ALLOCATOR>
+		BHAVESH_CXX20_CONSTEXPR matrix<T, Alloc> to_matrix() const {
+			matrix_detail::construction_holder<T, Alloc> h(M * N);
+			for (std::size_t i = 0; i != M * N; ++i) h.emplace_back(m_data[i]);
+			return matrix<T, Alloc>(matrix_take_ownership, h.release<true>(), M, N);
+		}
+
+		template <typename Alloc>
+		BHAVESH_CXX20_CONSTEXPR operator matrix<T, Alloc>() const {
+			return to_matrix<Alloc>();
+		}
+
+	public: /* shape information */
+		static constexpr std::size_t size() { return M * N; }
+		static constexpr std::pair<std::size_t, std::size_t> shape() { return { M, N }; }
+
+	public: /* accessors */
+		BHAVESH_CXX20_CONSTEXPR matrix_row<T> operator[](std::size_t i) {
+#			if BHAVESH_DEBUG
+				if (i >= M) throw std::out_of_range("Out of range element access attempted for matrix[i][j]");
+#			endif
+			return matrix_row<T>(M, N, m_data + N * i);
+		}
+		BHAVESH_CXX20_CONSTEXPR matrix_row<const T> operator[](std::size_t i) const {
+#			if BHAVESH_DEBUG
+				if (i >= M) throw std::out_of_range("Out of range element access attempted for matrix[i][j]");
+#			endif
+			return matrix_row<const T>(M, N, m_data + N * i);
+		}
+
+		constexpr T& operator()(std::size_t idx) {
+#			if BHAVESH_DEBUG
+				if (idx >= M * N) throw std::out_of_range("Out of range element access attempted for matrix(idx)");
+#			endif
+			return m_data[idx];
+		}
+		constexpr const T& operator()(std::size_t idx) const {
+#			if BHAVESH_DEBUG
+				if (idx >= M * N) throw std::out_of_range("Out of range element access attempted for matrix(idx)");
+#			endif
+			return m_data[idx];
+		}
+
+		constexpr T& operator()(std::size_t i, std::size_t j) {
+#			if BHAVESH_DEBUG
+				if (i >= M || j >= N) throw std::out_of_range("Out of range element access attempted for matrix(i, j)");
+#			endif
+			return m_data[i * N + j];
+		}
+		constexpr const T& operator()(std::size_t i, std::size_t j) const {
+#			if BHAVESH_DEBUG
+				if (i >= M || j >= N) throw std::out_of_range("Out of range element access attempted for matrix(i, j)");
+#			endif
+			return m_data[i * N + j];
+		}
+
+		constexpr T& get(std::size_t i, std::size_t j) {
+			if (i >= M || j >= N) throw std::out_of_range("Out of range element access attempted for matrix[i][j]");
+			return m_data[i * N + j];
+		}
+		constexpr const T& get(std::size_t i, std::size_t j) const {
+			if (i >= M || j >= N) throw std::out_of_range("Out of range element access attempted for matrix[i][j]");
+			return m_data[i * N + j];
+		}
+
+		constexpr T& _get(std::size_t i, std::size_t j) { return m_data[i * N + j]; }
+		constexpr const T& _get(std::size_t i, std::size_t j) const { return m_data[i * N + j]; }
+		constexpr T& _get(std::size_t idx) { return m_data[idx]; }
+		constexpr const T& _get(std::size_t idx) const { return m_data[idx]; }
+
+		constexpr T* data() { return m_data; }
+		constexpr const T* data() const { return m_data; }
+
+		// the elements as a matrix_view, for the view-taking parts of the library (gemm, reductions, io)
+		BHAVESH_CXX20_CONSTEXPR matrix_view<const T> view() const noexcept { return matrix_view<const T>(m_data, M, N, N); }
+
+	public: /* comparison */
+		template <typename Oth>
+		constexpr bool operator==(const fixed_matrix<Oth, M, N>& oth) const {
+			for (std::size_t i = 0; i != M * N; ++i) if (m_data[i] != oth._get(i)) return false;
+			return true;
+		}
+		template <typename Oth>
+		constexpr bool operator!=(const fixed_matrix<Oth, M, N>& oth) const { return !(*this == oth); }
+
+	public: /* transpose */
+		constexpr fixed_matrix<T, N, M> make_transpose() const {
+			fixed_matrix<T, N, M> ans;
+			fixed_detail::for_each_index<M * N>([&](auto idx) {
+				const std::size_t i = idx / N, j = idx % N;
+				ans._get(j, i) = m_data[idx];
+			});
+			return ans;
+		}
+
+		template <std::size_t M_ = M, typename = std::enable_if_t<M_ == N>>
+		constexpr fixed_matrix& transpose_inplace() {
+			// every (i, j) above the diagonal swaps with its mirror; the test is on constants once unrolled, so only those pairs remain
+			fixed_detail::for_each_index<N * N>([&](auto idx) {
+				const std::size_t i = idx / N, j = idx % N;
+				if (i < j) {
+					T tmp = m_data[i * N + j];
+					m_data[i * N + j] = m_data[j * N + i];
+					m_data[j * N + i] = tmp;
+				}
+			});
+			return *this;
+		}
+
+	public: /* elementwise arithmetic */
+		template <typename By, typename To = matrix_detail::addition_t<const T&, const By&>>
+		constexpr fixed_matrix<To, M, N> add(const fixed_matrix<By, M, N>& oth) const {
+			fixed_matrix<To, M, N> ans;
+			fixed_detail::for_each_index<M * N>([&](auto i) { ans._get(i) = m_data[i] + oth._get(i); });
+			return ans;
+		}
+		// mixed with the dynamic matrix; shape is checked at runtime and the result is dynamic
+		template <typename By, typename Alloc, typename To = matrix_detail::addition_t<const T&, const By&>>
+		BHAVESH_CXX20_CONSTEXPR matrix<To, Alloc> add(const matrix<By, Alloc>& oth) const {
+			return fixed_detail::zip_dynamic<To, Alloc>(*this, oth, std::plus<>{}, "Addition of matrices requires same shape");
+		}
+		template <typename By, typename = std::enable_if_t<std::is_convertible<matrix_detail::addition_t<T, const By&>, T>::value>>
+		constexpr fixed_matrix& add_eq(const fixed_matrix<By, M, N>& oth) {
+			fixed_detail::for_each_index<M * N>([&](auto i) { m_data[i] = m_data[i] + oth._get(i); });
+			return *this;
+		}
+
+		template <typename By, typename To = matrix_detail::subtraction_t<const T&, const By&>>
+		constexpr fixed_matrix<To, M, N> sub(const fixed_matrix<By, M, N>& oth) const {
+			fixed_matrix<To, M, N> ans;
+			fixed_detail::for_each_index<M * N>([&](auto i) { ans._get(i) = m_data[i] - oth._get(i); });
+			return ans;
+		}
+		template <typename By, typename Alloc, typename To = matrix_detail::subtraction_t<const T&, const By&>>
+		BHAVESH_CXX20_CONSTEXPR matrix<To, Alloc> sub(const matrix<By, Alloc>& oth) const {
+			return fixed_detail::zip_dynamic<To, Alloc>(*this, oth, std::minus<>{}, "Subtraction of matrices requires same shape");
+		}
+		template <typename By, typename = std::enable_if_t<std::is_convertible<matrix_detail::subtraction_t<T, const By&>, T>::value>>
+		constexpr fixed_matrix& sub_eq(const fixed_matrix<By, M, N>& oth) {
+			fixed_detail::for_each_index<M * N>([&](auto i) { m_data[i] = m_data[i] - oth._get(i); });
+			return *this;
+		}
+
+		template <typename By, typename To = matrix_detail::multiplication_t<const T&, const By&>, typename = std::enable_if_t<!is_fixed_matrix<By>::value && !is_matrix<By>::value && !is_matrix_view<By>::value>>
+		constexpr fixed_matrix<To, M, N> mul(const By& oth) const {
+			fixed_matrix<To, M, N> ans;
+			fixed_detail::for_each_index<M * N>([&](auto i) { ans._get(i) = m_data[i] * oth; });
+			return ans;
+		}
+		template <typename By, typename = std::enable_if_t<!is_fixed_matrix<By>::value && !is_matrix<By>::value && !is_matrix_view<By>::value>>
+		constexpr fixed_matrix& mul_eq(const By& oth) {
+			fixed_detail::for_each_index<M * N>([&](auto i) { m_data[i] = static_cast<T>(m_data[i] * oth); });
+			return *this;
+		}
+
+	public: /* matrix-matrix multiplication */
+		template <typename By, std::size_t P, typename To = matrix_detail::multiplication_t<const T&, const By&>>
+		constexpr fixed_matrix<To, M, P> mul(const fixed_matrix<By, N, P>& oth) const {
+			fixed_matrix<To, M, P> ans;
+			fixed_detail::for_each_index<M * P>([&](auto idx) {
+				const std::size_t i = idx / P, j = idx % P;
+				ans._get(idx) = fixed_detail::dot<To, N, P>(m_data, oth.data(), i, j, std::make_index_sequence<N>{});
+			});
+			return ans;
+		}
+
+		template <std::size_t M_ = M, typename = std::enable_if_t<M_ == N>>
+		constexpr fixed_matrix& mul_eq(const fixed_matrix<T, N, N>& oth) {
+			return *this = this->mul(oth);
+		}
+
+		// mixed with the dynamic matrix; shape is checked at runtime and the result is dynamic
+		// the dynamic side can be any size, so this goes through the library's gemm with *this wrapped as a view (see view())
+		template <typename By, typename Alloc, typename To = matrix_detail::multiplication_t<const T&, const By&>>
+		matrix<To, Alloc> mul(const matrix<By, Alloc>& oth) const {
+			if (oth.shape().first != N) throw std::invalid_argument("Invalid shapes for multiplication of matrices");
+			matrix<To, Alloc> ans(M, oth.shape().second, uninitialized);
+			multiply_accumulate(ans, To(1), view(), To(0), oth);
+			return ans;
+		}
+
+	public: /* operators */
+		template <typename By>
+		constexpr auto operator+(const By& by) const { return this->add(by); }
+		template <typename By>
+		constexpr auto operator-(const By& by) const { return this->sub(by); }
+		template <typename By>
+		constexpr auto operator*(const By& by) const { return this->mul(by); }
+
+		template <typename By>
+		constexpr fixed_matrix& operator+=(const By& by) { return this->add_eq(by); }
+		template <typename By>
+		constexpr fixed_matrix& operator-=(const By& by) { return this->sub_eq(by); }
+		template <typename By>
+		constexpr fixed_matrix& operator*=(const By& by) { return this->mul_eq(by); }
+
+	private:
+		T m_data[M * N];
+	};
+
+	/* dynamic op fixed; matrix's own operators step aside for fixed_matrix (see is_fixed_matrix) so these are the ones chosen */
+
+	template <typename T, typename Alloc, typename By, std::size_t M, std::size_t N, typename To = matrix_detail::addition_t<const T&, const By&>>
+	BHAVESH_CXX20_CONSTEXPR matrix<To, Alloc> operator+(const matrix<T, Alloc>& a, const fixed_matrix<By, M, N>& b) {
+		return fixed_detail::zip_dynamic<To, Alloc>(a, b, std::plus<>{}, "Addition of matrices requires same shape");
+	}
+
+	template <typename T, typename Alloc, typename By, std::size_t M, std::size_t N, typename To = matrix_detail::subtraction_t<const T&, const By&>>
+	BHAVESH_CXX20_CONSTEXPR matrix<To, Alloc> operator-(const matrix<T, Alloc>& a, const fixed_matrix<By, M, N>& b) {
+		return fixed_detail::zip_dynamic<To, Alloc>(a, b, std::minus<>{}, "Subtraction of matrices requires same shape");
+	}
+
+	template <typename T, typename Alloc, typename By, std::size_t N, std::size_t P, typename To = matrix_detail::multiplication_t<const T&, const By&>>
+	matrix<To, Alloc> operator*(const matrix<T, Alloc>& a, const fixed_matrix<By, N, P>& b) {
+		if (a.shape().second != N) throw std::invalid_argument("Invalid shapes for multiplication of matrices");
+		matrix<To, Alloc> ans(a.shape().first, P, uninitialized);
+		multiply_accumulate(ans, To(1), a, To(0), b.view());
+		return ans;
+	}
+
+	template <typename T, std::size_t N>
+	constexpr fixed_matrix<T, N, N> make_identity() {
+		fixed_matrix<T, N, N> ans;
+		for (std::size_t i = 0; i != N; ++i) ans._get(i, i) = T(1);
+		return ans;
+	}
+
+}
+
+#endif // !BHAVESH_MATRIX_FIXED_H
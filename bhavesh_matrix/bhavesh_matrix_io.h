@@ -0,0 +1,512 @@
+#ifndef BHAVESH_MATRIX_IO_H
+#define BHAVESH_MATRIX_IO_H 0.1
+
+#include "bhavesh_matrix_v1.h"
+
+#include <fstream> // the writer
+#include <string> // paths
+#include <vector> // row staging for strided views
+#include <charconv> // std::from_chars, std::to_chars for csv
+
+#if defined(_WIN32)
+# ifndef NOMINMAX
+#   define NOMINMAX
+# endif
+# include <windows.h> // CreateFileMapping / MapViewOfFile
+#else
+# include <sys/mman.h> // mmap
+# include <sys/stat.h> // fstat
+# include <fcntl.h> // open
+# include <unistd.h> // close
+#endif
+
+namespace bhavesh {
+
+	/*
+	 * on-disk matrix format, version 1
+	 *     [0, 4096)       header: magic "BHMATRIX", version, byte order mark, dtype, element size, layout, rows, cols, data offset, alignment
+	 *                     (little fields first, zero padded to the end of the page)
+	 *     [4096, ...)     rows * cols elements, row-major, no padding between rows
+	 * the data starts on a page boundary so a mapping of the whole file can be used in place as a matrix's storage
+	 */
+	enum class matrix_dtype : std::uint32_t {
+		unknown = 0,
+		f32, f64,
+		i8, u8, i16, u16, i32, u32, i64, u64,
+		c64, c128 // std::complex<float>, std::complex<double>
+	};
+
+	enum class matrix_layout : std::uint32_t { row_major = 0 };
+
+	struct matrix_file_info {
+		std::uint32_t version;
+		matrix_dtype dtype;
+		std::size_t element_size;
+		matrix_layout layout;
+		std::size_t rows;
+		std::size_t cols;
+		std::size_t data_offset;
+		std::size_t alignment;
+	};
+
+	// read_only maps the file shared and unwritable; copy_on_write maps it private, so writes stay in memory and never reach the file
+	enum class map_mode { read_only, copy_on_write };
+
+	inline namespace detail {
+	namespace file_detail {
+		constexpr std::size_t header_bytes = 4096;
+		constexpr std::uint32_t version = 1;
+		constexpr std::uint32_t byte_order_mark = 0x01020304;
+		constexpr char magic[8] = { 'B', 'H', 'M', 'A', 'T', 'R', 'I', 'X' };
+
+		struct header {
+			char magic[8];
+			std::uint32_t version;
+			std::uint32_t byte_order;
+			std::uint32_t dtype;
+			std::uint32_t element_size;
+			std::uint32_t layout;
+			std::uint32_t reserved;
+			std::uint64_t rows;
+			std::uint64_t cols;
+			std::uint64_t data_offset;
+			std::uint64_t alignment;
+		};
+		static_assert(sizeof(header) <= header_bytes, "file header must fit its page");
+
+		template <typename T>
+		constexpr matrix_dtype dtype_of() noexcept {
+			if BHAVESH_CXX17_CONSTEXPR (std::is_same<T, float>::value) return matrix_dtype::f32;
+			else if BHAVESH_CXX17_CONSTEXPR (std::is_same<T, double>::value) return matrix_dtype::f64;
+			else if BHAVESH_CXX17_CONSTEXPR (std::is_same<T, std::complex<float>>::value) return matrix_dtype::c64;
+			else if BHAVESH_CXX17_CONSTEXPR (std::is_same<T, std::complex<double>>::value) return matrix_dtype::c128;
+			else if BHAVESH_CXX17_CONSTEXPR (std::is_integral<T>::value && !std::is_same<T, bool>::value) {
+				constexpr bool s = std::is_signed<T>::value;
+				switch (sizeof(T)) {
+				case 1: return s ? matrix_dtype::i8 : matrix_dtype::u8;
+				case 2: return s ? matrix_dtype::i16 : matrix_dtype::u16;
+				case 4: return s ? matrix_dtype::i32 : matrix_dtype::u32;
+				case 8: return s ? matrix_dtype::i64 : matrix_dtype::u64;
+				default: return matrix_dtype::unknown;
+				}
+			}
+			else return matrix_dtype::unknown;
+		}
+
+		inline std::runtime_error error(const std::string& path, const char* what) {
+			return std::runtime_error("matrix file '" + path + "': " + what);
+		}
+
+		// file_size is 64 bit even on 32 bit targets; files past 4 GB are streamed there (out_of_core_matrix), never mapped whole
+		inline matrix_file_info parse(const std::string& path, const void* bytes, std::uint64_t file_size) {
+			if (file_size < header_bytes) throw error(path, "too small to hold a header");
+			header h;
+			std::memcpy(&h, bytes, sizeof(h));
+			if (std::memcmp(h.magic, magic, sizeof(magic)) != 0) throw error(path, "not a matrix file");
+			if (h.byte_order != byte_order_mark) throw error(path, "written with a different byte order");
+			if (h.version != version) throw error(path, "unsupported format version");
+			if (h.layout != static_cast<std::uint32_t>(matrix_layout::row_major)) throw error(path, "unsupported layout");
+			if (h.data_offset != header_bytes || h.element_size == 0) throw error(path, "corrupt header");
+			const std::uint64_t limit = ~std::uint64_t(0) / h.element_size;
+			if (h.cols && h.rows > limit / h.cols) throw error(path, "corrupt header");
+			if (file_size - header_bytes < h.rows * h.cols * h.element_size) throw error(path, "truncated");
+			if (h.rows > std::numeric_limits<std::size_t>::max() || h.cols > std::numeric_limits<std::size_t>::max()) throw error(path, "too large for this platform");
+			return { h.version, static_cast<matrix_dtype>(h.dtype), h.element_size, static_cast<matrix_layout>(h.layout),
+				static_cast<std::size_t>(h.rows), static_cast<std::size_t>(h.cols), static_cast<std::size_t>(h.data_offset), static_cast<std::size_t>(h.alignment) };
+		}
+
+		template <typename T>
+		void check_type(const std::string& path, const matrix_file_info& info) {
+			if (info.dtype != dtype_of<T>() || info.element_size != sizeof(T)) throw error(path, "element type does not match the requested one");
+		}
+
+		// the whole header page for a rows x cols file of T
+		template <typename T>
+		void make_header(char (&page)[header_bytes], std::size_t rows, std::size_t cols) {
+			header h{};
+			std::memcpy(h.magic, magic, sizeof(h.magic));
+			h.version = version;
+			h.byte_order = byte_order_mark;
+			h.dtype = static_cast<std::uint32_t>(dtype_of<T>());
+			h.element_size = sizeof(T);
+			h.layout = static_cast<std::uint32_t>(matrix_layout::row_major);
+			h.rows = rows;
+			h.cols = cols;
+			h.data_offset = header_bytes;
+			h.alignment = header_bytes;
+			std::memset(page, 0, header_bytes);
+			std::memcpy(page, &h, sizeof(h));
+		}
+
+		struct mapping {
+			void* base = nullptr;
+			std::size_t bytes = 0;
+		};
+
+		// whole file (an empty one maps to nullptr); the handles are closed again right away, the mapping keeps the file alive
+		inline mapping map_file(const std::string& path, map_mode mode) {
+			mapping m;
+#		if defined(_WIN32)
+			HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (file == INVALID_HANDLE_VALUE) throw error(path, "could not be opened");
+			LARGE_INTEGER size;
+			if (!GetFileSizeEx(file, &size)) { CloseHandle(file); throw error(path, "could not be sized"); }
+			m.bytes = static_cast<std::size_t>(size.QuadPart);
+			if (m.bytes == 0) { CloseHandle(file); return m; } // nothing to map
+			HANDLE map = CreateFileMappingA(file, nullptr, mode == map_mode::read_only ? PAGE_READONLY : PAGE_WRITECOPY, 0, 0, nullptr);
+			CloseHandle(file);
+			if (!map) throw error(path, "could not be mapped");
+			m.base = MapViewOfFile(map, mode == map_mode::read_only ? FILE_MAP_READ : FILE_MAP_COPY, 0, 0, 0);
+			CloseHandle(map);
+			if (!m.base) throw error(path, "could not be mapped");
+#		else
+			const int fd = ::open(path.c_str(), O_RDONLY);
+			if (fd < 0) throw error(path, "could not be opened");
+			struct stat st;
+			if (::fstat(fd, &st) != 0) { ::close(fd); throw error(path, "could not be sized"); }
+			m.bytes = static_cast<std::size_t>(st.st_size);
+			if (m.bytes == 0) { ::close(fd); return m; } // nothing to map
+			void* p = ::mmap(nullptr, m.bytes, mode == map_mode::read_only ? PROT_READ : PROT_READ | PROT_WRITE,
+				mode == map_mode::read_only ? MAP_SHARED : MAP_PRIVATE, fd, 0); // shared like the windows view, so both see other writers the same way
+			::close(fd);
+			if (p == MAP_FAILED) throw error(path, "could not be mapped");
+			m.base = p;
+#		endif
+			return m;
+		}
+
+		inline void unmap(void* base, std::size_t bytes) noexcept {
+			if (!base) return;
+#		if defined(_WIN32)
+			static_cast<void>(bytes);
+			UnmapViewOfFile(base);
+#		else
+			::munmap(base, bytes);
+#		endif
+		}
+
+		// anonymous memory laid out like a mapped file (a header page in front), so matrix_mapped_allocator can release both the same way
+		inline void* map_anonymous(std::size_t bytes) {
+#		if defined(_WIN32)
+			const unsigned long long size = bytes;
+			HANDLE map = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, static_cast<DWORD>(size >> 32), static_cast<DWORD>(size), nullptr);
+			if (!map) throw std::bad_alloc();
+			void* p = MapViewOfFile(map, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+			CloseHandle(map);
+			if (!p) throw std::bad_alloc();
+			return p;
+#		else
+			void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (p == MAP_FAILED) throw std::bad_alloc();
+			return p;
+#		endif
+		}
+	}
+	}
+
+	/*
+	 * allocation policy for matrices living in a mapping: element storage starts one header page into its mapping
+	 * map_matrix_file hands a copy-on-write file mapping to a matrix through this policy; anything else the matrix allocates
+	 * (copies, reshaping assignments) gets an anonymous mapping of the same shape, so deallocate can always unmap
+	 */
+	struct matrix_mapped_allocator {
+		template <typename T>
+		static BHAVESH_CXX20_CONSTEXPR T* allocate(std::size_t s) {
+#if BHAVESH_CXX20
+			if (std::is_constant_evaluated()) return std::allocator<T>{}.allocate(s);
+#endif
+			static_assert(alignof(T) <= file_detail::header_bytes, "over-aligned types are not supported by matrix_mapped_allocator");
+			return reinterpret_cast<T*>(static_cast<char*>(file_detail::map_anonymous(file_detail::header_bytes + s * sizeof(T))) + file_detail::header_bytes);
+		}
+		template <typename T>
+		static BHAVESH_CXX20_CONSTEXPR void deallocate(T* ptr, std::size_t s) {
+#if BHAVESH_CXX20
+			if (std::is_constant_evaluated()) {
+				std::allocator<T>{}.deallocate(ptr, s);
+				return;
+			}
+#endif
+			if (!ptr) return;
+			file_detail::unmap(reinterpret_cast<char*>(ptr) - file_detail::header_bytes, file_detail::header_bytes + s * sizeof(T));
+		}
+	};
+
+	// header of a matrix file, without touching the data
+	inline matrix_file_info read_matrix_file_info(const std::string& path) {
+		std::ifstream in(path, std::ios::binary);
+		if (!in) throw file_detail::error(path, "could not be opened");
+		char page[file_detail::header_bytes];
+		in.read(page, sizeof(page));
+		in.seekg(0, std::ios::end);
+		return file_detail::parse(path, page, in ? static_cast<std::uint64_t>(in.tellg()) : 0);
+	}
+
+	// writes a matrix or any view (blocks, transposes) in the format above; contiguous rows are written straight from the source
+	template <typename X, typename = std::enable_if_t<is_matrix<X>::value || is_matrix_view<X>::value>>
+	void write_matrix_file(const std::string& path, const X& mat) {
+		using T = std::remove_cv_t<typename X::value_type>;
+		static_assert(file_detail::dtype_of<T>() != matrix_dtype::unknown, "no matrix file dtype for this element type");
+
+		const std::size_t rows = mat.shape().first, cols = mat.shape().second;
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		if (!out) throw file_detail::error(path, "could not be opened for writing");
+		char page[file_detail::header_bytes];
+		file_detail::make_header<T>(page, rows, cols);
+		out.write(page, sizeof(page));
+
+		const auto s = view_detail::strides(mat);
+		const T* data = mat.data();
+		if (s.second == 1 && s.first == static_cast<std::ptrdiff_t>(cols)) {
+			out.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(rows * cols * sizeof(T)));
+		}
+		else if (s.second == 1) {
+			for (std::size_t i = 0; i != rows; ++i) out.write(reinterpret_cast<const char*>(data + static_cast<std::ptrdiff_t>(i) * s.first), static_cast<std::streamsize>(cols * sizeof(T)));
+		}
+		else {
+			std::vector<T> row(cols);
+			for (std::size_t i = 0; i != rows; ++i) {
+				for (std::size_t j = 0; j != cols; ++j) row[j] = mat._get(i, j);
+				out.write(reinterpret_cast<const char*>(row.data()), static_cast<std::streamsize>(cols * sizeof(T)));
+			}
+		}
+		out.flush();
+		if (!out) throw file_detail::error(path, "write failed");
+	}
+
+	/*
+	 * a matrix file mapped into memory; the elements are used where they lie in the mapping, nothing is read up front or copied
+	 * read_only hands out matrix_view<const T>; copy_on_write also hands out matrix_view<T> and can give the mapping away to a
+	 * matrix<T, matrix_mapped_allocator> (release), whose writes then stay private to the process
+	 */
+	template <typename T>
+	class mapped_matrix {
+	public:
+		static_assert(file_detail::dtype_of<T>() != matrix_dtype::unknown, "no matrix file dtype for this element type");
+
+		explicit mapped_matrix(const std::string& path, map_mode mode = map_mode::read_only) : m_map(file_detail::map_file(path, mode)), m_mode(mode) {
+			try {
+				const matrix_file_info info = file_detail::parse(path, m_map.base, m_map.bytes);
+				file_detail::check_type<T>(path, info);
+				m = info.rows;
+				n = info.cols;
+			}
+			catch (...) {
+				file_detail::unmap(m_map.base, m_map.bytes);
+				throw;
+			}
+		}
+		mapped_matrix(mapped_matrix&& oth) noexcept : m_map(std::exchange(oth.m_map, {})), m_mode(oth.m_mode), m(std::exchange(oth.m, 0)), n(std::exchange(oth.n, 0)) {}
+		mapped_matrix& operator=(mapped_matrix&& oth) noexcept {
+			if (this != &oth) {
+				file_detail::unmap(m_map.base, m_map.bytes);
+				m_map = std::exchange(oth.m_map, {});
+				m_mode = oth.m_mode;
+				m = std::exchange(oth.m, 0);
+				n = std::exchange(oth.n, 0);
+			}
+			return *this;
+		}
+		mapped_matrix(const mapped_matrix&) = delete;
+		mapped_matrix& operator=(const mapped_matrix&) = delete;
+		~mapped_matrix() { file_detail::unmap(m_map.base, m_map.bytes); }
+
+		std::pair<std::size_t, std::size_t> shape() const noexcept { return { m, n }; }
+		std::size_t size() const noexcept { return m * n; }
+		map_mode mode() const noexcept { return m_mode; }
+
+		const T* data() const noexcept { return elements(); }
+		matrix_view<const T> view() const noexcept { return matrix_view<const T>(elements(), m, n, n); }
+		matrix_view<T> mutable_view() {
+			if (m_mode != map_mode::copy_on_write) throw std::logic_error("a read-only mapping cannot be written to");
+			return matrix_view<T>(elements(), m, n, n);
+		}
+
+		// gives the mapping to a matrix, which unmaps it when it is done; this object is left empty
+		matrix<T, matrix_mapped_allocator> release() {
+			if (m_mode != map_mode::copy_on_write) throw std::logic_error("a read-only mapping cannot be adopted by a matrix");
+			T* data = elements();
+			const std::size_t rows = std::exchange(m, 0), cols = std::exchange(n, 0);
+			if (m_map.bytes != file_detail::header_bytes + rows * cols * sizeof(T)) { // trailing bytes after the data would not be unmapped
+				file_detail::unmap(m_map.base, m_map.bytes);
+				m_map = {};
+				throw std::logic_error("matrix file has trailing bytes after its elements; use view() instead");
+			}
+			m_map = {};
+			return matrix<T, matrix_mapped_allocator>(matrix_take_ownership, data, rows, cols);
+		}
+
+	private:
+		T* elements() const noexcept { return m_map.base ? reinterpret_cast<T*>(static_cast<char*>(m_map.base) + file_detail::header_bytes) : nullptr; }
+
+		file_detail::mapping m_map;
+		map_mode m_mode;
+		std::size_t m = 0;
+		std::size_t n = 0;
+	};
+
+	// the file as a copy-on-write matrix, without reading or copying it
+	template <typename T>
+	matrix<T, matrix_mapped_allocator> map_matrix_file(const std::string& path) {
+		return mapped_matrix<T>(path, map_mode::copy_on_write).release();
+	}
+
+
+	inline namespace detail {
+	namespace csv_detail {
+		inline std::runtime_error error(const std::string& path, std::size_t row, const char* what) {
+			return std::runtime_error("csv file '" + path + "', row " + std::to_string(row + 1) + ": " + what);
+		}
+
+		inline bool space(char c) noexcept { return c == ' ' || c == '\t' || c == '\r'; }
+		inline const char* skip_space(const char* p, const char* last) noexcept {
+			while (p != last && space(*p)) ++p;
+			return p;
+		}
+		inline bool blank(const char* first, const char* last) noexcept { return skip_space(first, last) == last; }
+
+		inline const char* line_end(const char* p, const char* end) noexcept {
+			const void* nl = std::memchr(p, '\n', static_cast<std::size_t>(end - p));
+			return nl ? static_cast<const char*>(nl) : end;
+		}
+		inline const char* next_line(const char* p, const char* end) noexcept {
+			p = line_end(p, end);
+			return p == end ? end : p + 1;
+		}
+
+		// values in a line; a space or tab delimiter means runs of blanks separate the values
+		inline std::size_t count_fields(const char* first, const char* last, char delimiter) noexcept {
+			if (!space(delimiter)) return 1 + static_cast<std::size_t>(std::count(first, last, delimiter));
+			std::size_t fields = 0;
+			for (first = skip_space(first, last); first != last; first = skip_space(first, last)) {
+				++fields;
+				while (first != last && !space(*first)) ++first;
+			}
+			return fields;
+		}
+
+		// rows in [p, end); blank lines are not rows
+		inline std::size_t count_rows(const char* p, const char* end) noexcept {
+			std::size_t rows = 0;
+			for (; p != end; p = next_line(p, end)) rows += !blank(p, line_end(p, end));
+			return rows;
+		}
+
+		// the rows in [p, end), n values each, into out; row is the index of the first of them (for messages)
+		template <typename T>
+		void parse_rows(const std::string& path, const char* p, const char* end, T* out, std::size_t n, std::size_t row, char delimiter) {
+			const bool spaced = space(delimiter);
+			for (; p != end; p = next_line(p, end)) {
+				const char* const last = line_end(p, end);
+				if (blank(p, last)) continue;
+				const char* q = p;
+				for (std::size_t j = 0; j != n; ++j) {
+					if (j && !spaced) {
+						if (q == last || *q != delimiter) throw error(path, row, "too few values");
+						++q;
+					}
+					q = skip_space(q, last);
+					if (q == last) throw error(path, row, spaced ? "too few values" : "empty value");
+					if (*q == '+') ++q; // from_chars takes no leading '+'
+					const std::from_chars_result r = std::from_chars(q, last, out[j]);
+					if (r.ec == std::errc::result_out_of_range) throw error(path, row, "value out of range");
+					if (r.ec != std::errc{}) throw error(path, row, "malformed value");
+					q = skip_space(r.ptr, last);
+				}
+				if (q != last) throw error(path, row, *q == delimiter ? "too many values" : "malformed value");
+				out += n;
+				++row;
+			}
+		}
+
+		// longest text to_chars writes for one value of any arithmetic type, plus its delimiter
+		constexpr std::size_t value_width = 48;
+	}
+	}
+
+	/*
+	 * a delimited text file (one row per line, blank lines ignored, skip_lines leading lines such as a header skipped) as a matrix
+	 * the file is mapped rather than read, cut into line aligned chunks, and the chunks are parsed on matrix_scheduler's pool with
+	 * std::from_chars: a first pass counts each chunk's rows, the second parses every chunk straight into its rows of the result
+	 * throws std::runtime_error naming the row for ragged or malformed input
+	 */
+	template <typename T, typename Alloc = BHAVESH_MATRIX_DEFAULT_ALLOCATOR>
+	matrix<T, Alloc> read_csv(const std::string& path, char delimiter = ',', std::size_t skip_lines = 0) {
+		static_assert(std::is_arithmetic<T>::value && !std::is_same<T, bool>::value, "read_csv parses arithmetic element types");
+		struct unmapper {
+			file_detail::mapping map;
+			~unmapper() { file_detail::unmap(map.base, map.bytes); }
+		} const file{ file_detail::map_file(path, map_mode::read_only) };
+
+		const char* first = static_cast<const char*>(file.map.base);
+		const char* const end = first + file.map.bytes;
+		if (end - first >= 3 && std::memcmp(first, "\xEF\xBB\xBF", 3) == 0) first += 3; // utf-8 byte order mark
+		for (; skip_lines && first != end; --skip_lines) first = csv_detail::next_line(first, end);
+		while (first != end && csv_detail::blank(first, csv_detail::line_end(first, end))) first = csv_detail::next_line(first, end);
+		if (first == end) return matrix<T, Alloc>();
+		const std::size_t n = csv_detail::count_fields(first, csv_detail::line_end(first, end), delimiter);
+
+		const std::size_t bytes = static_cast<std::size_t>(end - first);
+		const std::size_t chunks = sched_detail::worth_splitting(bytes / 8) ? 4 * sched_detail::scheduler::instance().concurrency() : 1; // ~8 bytes a value
+		std::vector<const char*> cuts(chunks + 1, end);
+		cuts[0] = first;
+		for (std::size_t c = 1; c != chunks; ++c) {
+			const char* const at = first + bytes / chunks * c;
+			cuts[c] = at <= cuts[c - 1] ? cuts[c - 1] : at[-1] == '\n' ? at : csv_detail::next_line(at, end);
+		}
+
+		std::vector<std::size_t> rows(chunks + 1, 0); // rows[c] becomes the index of chunk c's first row
+		sched_detail::scheduler::instance().parallel_for(chunks, [&cuts, &rows](std::size_t c) { rows[c + 1] = csv_detail::count_rows(cuts[c], cuts[c + 1]); });
+		for (std::size_t c = 0; c != chunks; ++c) rows[c + 1] += rows[c];
+
+		matrix<T, Alloc> result(rows[chunks], n, uninitialized);
+		T* const data = result.data();
+		sched_detail::scheduler::instance().parallel_for(chunks, [&](std::size_t c) {
+			csv_detail::parse_rows(path, cuts[c], cuts[c + 1], data + rows[c] * n, n, rows[c], delimiter);
+		});
+		return result;
+	}
+
+	/*
+	 * a matrix or view as delimited text, one row per line, values in the shortest form that reads back to the same value
+	 * rows are formatted in blocks on matrix_scheduler's pool and written in order; one block per thread is in flight, each at most
+	 * 16K values of worst case width (under 1 MB), so memory use stays bounded by the thread count rather than the matrix
+	 */
+	template <typename X, typename = std::enable_if_t<is_matrix<X>::value || is_matrix_view<X>::value>>
+	void write_csv(const std::string& path, const X& mat, char delimiter = ',') {
+		using T = std::remove_cv_t<typename X::value_type>;
+		static_assert(std::is_arithmetic<T>::value && !std::is_same<T, bool>::value, "write_csv formats arithmetic element types");
+
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		if (!out) throw std::runtime_error("csv file '" + path + "': could not be opened for writing");
+
+		const std::size_t m = mat.shape().first, n = mat.shape().second;
+		const auto s = view_detail::strides(mat);
+		const T* const data = mat.data();
+		const std::size_t block = std::max<std::size_t>(1, (std::size_t(1) << 14) / std::max<std::size_t>(1, n)); // rows formatted by one task
+		const std::size_t group = sched_detail::worth_splitting(m * n) ? sched_detail::scheduler::instance().concurrency() : 1; // blocks in flight
+		std::vector<std::string> text(group);
+		for (std::size_t first = 0; first < m; first += block * group) {
+			sched_detail::scheduler::instance().parallel_for(group, [&, first](std::size_t g) {
+				const std::size_t lo = std::min(m, first + g * block), hi = std::min(m, lo + block);
+				std::string& t = text[g];
+				t.resize((hi - lo) * (n * csv_detail::value_width + 1));
+				char* p = &t[0];
+				for (std::size_t i = lo; i != hi; ++i) {
+					const T* row = data + static_cast<std::ptrdiff_t>(i) * s.first;
+					for (std::size_t j = 0; j != n; ++j) {
+						p = std::to_chars(p, p + csv_detail::value_width, row[static_cast<std::ptrdiff_t>(j) * s.second]).ptr;
+						*p++ = j + 1 == n ? '\n' : delimiter;
+					}
+					if (n == 0) *p++ = '\n';
+				}
+				t.resize(static_cast<std::size_t>(p - t.data()));
+			});
+			for (const std::string& t : text) out.write(t.data(), static_cast<std::streamsize>(t.size()));
+		}
+		out.flush();
+		if (!out) throw std::runtime_error("csv file '" + path + "': write failed");
+	}
+
+}
+
+#endif // !BHAVESH_MATRIX_IO_H
@@ -0,0 +1,683 @@
+#ifndef BHAVESH_MATRIX_LINALG_H
+#define BHAVESH_MATRIX_LINALG_H 0.1
+
+#include "bhavesh_matrix_v1.h"
+
+#include <vector> // pivots, reflector scalars
+
+#ifndef BHAVESH_MATRIX_FACTOR_BLOCK
+# define BHAVESH_MATRIX_FACTOR_BLOCK 64 // panel width of the blocked factorizations: the trailing updates are products of this depth
+#endif
+
+namespace bhavesh {
+
+	inline namespace detail {
+	namespace linalg_detail {
+		constexpr std::size_t block = BHAVESH_MATRIX_FACTOR_BLOCK;
+
+		template <typename T> T conj(const T& x) { return x; }
+		template <typename T> std::complex<T> conj(const std::complex<T>& x) { return std::conj(x); }
+		template <typename T> T real(const T& x) { return x; }
+		template <typename T> T real(const std::complex<T>& x) { return x.real(); }
+		template <typename T> T imag(const T&) { return T{}; }
+		template <typename T> T imag(const std::complex<T>& x) { return x.imag(); }
+
+		// a field-typed row-major copy of a matrix or view of any arithmetic type
+		template <typename T, typename Alloc = BHAVESH_MATRIX_DEFAULT_ALLOCATOR, typename X>
+		matrix<T, Alloc> load(const X& x) {
+			const std::size_t m = x.shape().first, n = x.shape().second;
+			matrix<T, Alloc> a(m, n, uninitialized);
+			const auto s = view_detail::strides(x);
+			const auto* src = x.data();
+			T* const dst = a.data();
+			sched_detail::for_ranges<T>(m, [src, dst, s, n](std::size_t first, std::size_t last) {
+				for (std::size_t i = first; i != last; ++i) {
+					for (std::size_t j = 0; j != n; ++j) dst[i * n + j] = static_cast<T>(src[static_cast<std::ptrdiff_t>(i) * s.first + static_cast<std::ptrdiff_t>(j) * s.second]);
+				}
+			}, n);
+			return a;
+		}
+
+		/*
+		 * C = alpha * A * B + beta * C on blocks of row-major arrays (A and B by strides, so transposes are free; C's columns contiguous)
+		 * every factorization below spends nearly all its flops here: the blocked gemm on matrix_scheduler's pool for arithmetic types,
+		 * a row-split loop otherwise (complex)
+		 */
+		template <typename T>
+		void gemm_update(std::size_t m, std::size_t n, std::size_t k, const T& alpha, const T* a, std::ptrdiff_t ra, std::ptrdiff_t ca,
+			const T* b, std::ptrdiff_t rb, std::ptrdiff_t cb, const T& beta, T* c, std::ptrdiff_t ldc) {
+			if (!m || !n) return;
+			if BHAVESH_CXX17_CONSTEXPR (gemm_detail::use_blocked_gemm<T, T, T>::value) {
+				if (k) {
+					gemm_detail::parallel_gemm<T>(m, n, k, alpha, a, ra, ca, b, rb, cb, beta, c, ldc, 1);
+					return;
+				}
+			}
+			sched_detail::for_ranges<T>(m, [=](std::size_t first, std::size_t last) {
+				for (std::size_t i = first; i != last; ++i) {
+					T* const c_row = c + static_cast<std::ptrdiff_t>(i) * ldc;
+					if (beta == T{}) std::fill(c_row, c_row + n, T{});
+					else if (beta != T(1)) for (std::size_t j = 0; j != n; ++j) c_row[j] *= beta;
+					for (std::size_t p = 0; p != k; ++p) {
+						const T aip = alpha * a[static_cast<std::ptrdiff_t>(i) * ra + static_cast<std::ptrdiff_t>(p) * ca];
+						const T* b_row = b + static_cast<std::ptrdiff_t>(p) * rb;
+						for (std::size_t j = 0; j != n; ++j) c_row[j] += aip * b_row[static_cast<std::ptrdiff_t>(j) * cb];
+					}
+				}
+			}, n * k + 1);
+		}
+
+		/*
+		 * X = op(T)^-1 X for an n x n triangle and an n x r row-major X (rows ldx apart), in diagonal blocks: each block is solved directly, then
+		 * the rest of X is updated by one product with the block's off-diagonal part
+		 * the triangle is read as t[i * rt + j * ct], conjugated if conjugate: the upper triangle L^H of a stored lower L is (t, 1, n, true)
+		 */
+		template <bool lower, bool unit, bool conjugate, typename T>
+		void trsm(std::size_t n, const T* t, std::ptrdiff_t rt, std::ptrdiff_t ct, T* x, std::size_t r, std::size_t ldx) {
+			const auto tri = [t, rt, ct](std::size_t i, std::size_t j) {
+				const T& v = t[static_cast<std::ptrdiff_t>(i) * rt + static_cast<std::ptrdiff_t>(j) * ct];
+				return conjugate ? linalg_detail::conj(v) : v;
+			};
+			const auto diagonal = [&tri, x, r, ldx](std::size_t i0, std::size_t i1) { // rows [i0, i1) of X against the block's own triangle
+				sched_detail::for_ranges<T>(r, [&tri, x, ldx, i0, i1](std::size_t c0, std::size_t c1) {
+					for (std::size_t s = 0; s != i1 - i0; ++s) {
+						const std::size_t i = lower ? i0 + s : i1 - 1 - s;
+						T* const xi = x + i * ldx;
+						for (std::size_t p = lower ? i0 : i + 1; p != (lower ? i : i1); ++p) {
+							const T l = tri(i, p);
+							const T* xp = x + p * ldx;
+							for (std::size_t c = c0; c != c1; ++c) xi[c] -= l * xp[c];
+						}
+						if (!unit) {
+							const T d = tri(i, i);
+							for (std::size_t c = c0; c != c1; ++c) xi[c] /= d;
+						}
+					}
+				}, (i1 - i0) * (i1 - i0));
+			};
+			// the off-diagonal part of a block column, conjugated into a copy when it has to be
+			constexpr bool copy = conjugate && !std::is_arithmetic<T>::value;
+			matrix<T> scratch;
+			const auto off_diagonal = [&](std::size_t i0, std::size_t rows, std::size_t j0, std::size_t cols, std::ptrdiff_t& ra, std::ptrdiff_t& ca) -> const T* {
+				if (!copy) {
+					ra = rt;
+					ca = ct;
+					return t + static_cast<std::ptrdiff_t>(i0) * rt + static_cast<std::ptrdiff_t>(j0) * ct;
+				}
+				if (scratch.size() < rows * cols) scratch = matrix<T>(rows, cols, uninitialized);
+				for (std::size_t i = 0; i != rows; ++i) for (std::size_t j = 0; j != cols; ++j) scratch.data()[i * cols + j] = tri(i0 + i, j0 + j);
+				ra = static_cast<std::ptrdiff_t>(cols);
+				ca = 1;
+				return scratch.data();
+			};
+
+			std::ptrdiff_t ra = 0, ca = 0;
+			if BHAVESH_CXX17_CONSTEXPR (lower) {
+				for (std::size_t i0 = 0; i0 < n; i0 += block) {
+					const std::size_t i1 = std::min(n, i0 + block);
+					diagonal(i0, i1);
+					if (i1 == n) break;
+					const T* a = off_diagonal(i1, n - i1, i0, i1 - i0, ra, ca);
+					gemm_update<T>(n - i1, r, i1 - i0, T(-1), a, ra, ca, x + i0 * ldx, static_cast<std::ptrdiff_t>(ldx), 1, T(1), x + i1 * ldx, static_cast<std::ptrdiff_t>(ldx));
+				}
+			}
+			else {
+				for (std::size_t i1 = n; i1 > 0;) {
+					const std::size_t i0 = i1 > block ? i1 - block : 0;
+					diagonal(i0, i1);
+					if (i0) {
+						const T* a = off_diagonal(0, i0, i0, i1 - i0, ra, ca);
+						gemm_update<T>(i0, r, i1 - i0, T(-1), a, ra, ca, x + i0 * ldx, static_cast<std::ptrdiff_t>(ldx), 1, T(1), x, static_cast<std::ptrdiff_t>(ldx));
+					}
+					i1 = i0;
+				}
+			}
+		}
+
+		template <typename T, typename Alloc = BHAVESH_MATRIX_DEFAULT_ALLOCATOR, typename B>
+		matrix<T, Alloc> right_hand_side(const B& b, std::size_t n) {
+			if (b.shape().first != n) throw std::invalid_argument("Invalid shapes for solving a linear system");
+			return load<T, Alloc>(b);
+		}
+
+		/*
+		 * block reflector of panel columns [k0, k0 + b) of a Householder factored m x n array a: Q_k = H_k0 ... H_k0+b-1 = I - V T V^H,
+		 * V the unit lower trapezoidal (m - k0) x b reflector vectors, T upper triangular (compact WY form)
+		 * apply(c, cols, ldc, adjoint) multiplies rows [k0, m) of c by Q_k^H (adjoint) or Q_k with three products: W = V^H C, W = op(T) W, C -= V W
+		 */
+		template <typename T>
+		class block_reflector {
+		public:
+			block_reflector(const T* a, std::size_t m, std::size_t n, const T* tau, std::size_t k0, std::size_t b)
+				: rows(m - k0), width(b), v(m - k0, b, uninitialized), vh(b, m - k0, uninitialized), t(b, b, uninitialized) {
+				for (std::size_t i = 0; i != rows; ++i) {
+					for (std::size_t j = 0; j != b; ++j) {
+						const T x = i > j ? a[(k0 + i) * n + k0 + j] : i == j ? T(1) : T{};
+						v.data()[i * b + j] = x;
+						vh.data()[j * rows + i] = linalg_detail::conj(x);
+					}
+				}
+				// T(0:j, j) = -tau_j T(0:j, 0:j) V(:, 0:j)^H v_j
+				std::fill(t.data(), t.data() + b * b, T{});
+				std::vector<T> z(b);
+				for (std::size_t j = 0; j != b; ++j) {
+					t.data()[j * b + j] = tau[k0 + j];
+					if (tau[k0 + j] == T{}) continue;
+					for (std::size_t p = 0; p != j; ++p) {
+						T sum{};
+						for (std::size_t i = j; i != rows; ++i) sum += vh.data()[p * rows + i] * v.data()[i * b + j];
+						z[p] = sum;
+					}
+					for (std::size_t p = 0; p != j; ++p) {
+						T sum{};
+						for (std::size_t q = p; q != j; ++q) sum += t.data()[p * b + q] * z[q];
+						t.data()[p * b + j] = -tau[k0 + j] * sum;
+					}
+				}
+			}
+
+			void apply(T* c, std::size_t cols, std::size_t ldc, bool adjoint) const {
+				if (!cols) return;
+				matrix<T> w(width, cols, uninitialized);
+				gemm_update<T>(width, cols, rows, T(1), vh.data(), static_cast<std::ptrdiff_t>(rows), 1, c, static_cast<std::ptrdiff_t>(ldc), 1, T{}, w.data(), static_cast<std::ptrdiff_t>(cols));
+				// W = op(T) W, row by row from the top: row i only reads rows at or below it (T^H: at or above, so from the bottom)
+				const T* tt = t.data();
+				T* const wd = w.data();
+				const std::size_t b = width;
+				sched_detail::for_ranges<T>(cols, [tt, wd, b, cols, adjoint](std::size_t c0, std::size_t c1) {
+					if (adjoint) {
+						for (std::size_t i = b; i-- != 0;) {
+							T* const wi = wd + i * cols;
+							const T tii = linalg_detail::conj(tt[i * b + i]);
+							for (std::size_t c = c0; c != c1; ++c) wi[c] *= tii;
+							for (std::size_t p = 0; p != i; ++p) {
+								const T tpi = linalg_detail::conj(tt[p * b + i]);
+								const T* wp = wd + p * cols;
+								for (std::size_t c = c0; c != c1; ++c) wi[c] += tpi * wp[c];
+							}
+						}
+					}
+					else {
+						for (std::size_t i = 0; i != b; ++i) {
+							T* const wi = wd + i * cols;
+							const T tii = tt[i * b + i];
+							for (std::size_t c = c0; c != c1; ++c) wi[c] *= tii;
+							for (std::size_t p = i + 1; p != b; ++p) {
+								const T tip = tt[i * b + p];
+								const T* wp = wd + p * cols;
+								for (std::size_t c = c0; c != c1; ++c) wi[c] += tip * wp[c];
+							}
+						}
+					}
+				}, b * b);
+				gemm_update<T>(rows, cols, width, T(-1), v.data(), static_cast<std::ptrdiff_t>(width), 1, w.data(), static_cast<std::ptrdiff_t>(cols), 1, T(1), c, static_cast<std::ptrdiff_t>(ldc));
+			}
+
+		private:
+			std::size_t rows;
+			std::size_t width;
+			matrix<T> v;
+			matrix<T> vh;
+			matrix<T> t;
+		};
+	}
+	}
+
+	/*
+	 * PA = LU with partial pivoting, blocked: each panel of BHAVESH_MATRIX_FACTOR_BLOCK columns is factored directly, and the rest of the
+	 * matrix is updated with one triangular solve and one blocked product per panel, so for large n nearly all the work is the gemm
+	 * the factors are kept, so any number of right-hand sides can be solved against them afterwards (solve takes them all at once)
+	 */
+	template <typename T>
+	class lu_decomposition {
+	public:
+		static_assert(is_field<T>::value, "lu_decomposition needs a field type (floating point, or std::complex of one)");
+		using value_type = T;
+
+		template <typename X, typename = std::enable_if_t<is_matrix<X>::value || is_matrix_view<X>::value>>
+		explicit lu_decomposition(const X& a) : m_lu(linalg_detail::load<T>(a)) {
+			if (m_lu.shape().first != m_lu.shape().second) throw std::invalid_argument("lu_decomposition requires a square matrix");
+			factor();
+		}
+
+		std::size_t size() const noexcept { return m_lu.shape().first; }
+		// some pivot was exactly zero; the factors are still complete, but solve and inverse throw
+		bool singular() const noexcept { return m_singular; }
+		// L strictly below the diagonal (its unit diagonal is implied), U on and above it
+		const matrix<T>& factors() const noexcept { return m_lu; }
+		// row i was exchanged with row pivots()[i] at step i
+		const std::vector<std::size_t>& pivots() const noexcept { return m_pivots; }
+
+		matrix<T> lower() const {
+			const std::size_t n = size();
+			matrix<T> l(n, n);
+			for (std::size_t i = 0; i != n; ++i) {
+				std::copy(m_lu.data() + i * n, m_lu.data() + i * n + i, l.data() + i * n);
+				l.data()[i * n + i] = T(1);
+			}
+			return l;
+		}
+		matrix<T> upper() const {
+			const std::size_t n = size();
+			matrix<T> u(n, n);
+			for (std::size_t i = 0; i != n; ++i) std::copy(m_lu.data() + i * n + i, m_lu.data() + (i + 1) * n, u.data() + i * n + i);
+			return u;
+		}
+
+		// X with A X = B, B a matrix or view with size() rows; all columns go through each blocked triangular pass together
+		template <typename B, typename = std::enable_if_t<is_matrix<B>::value || is_matrix_view<B>::value>>
+		matrix<T> solve(const B& b) const {
+			matrix<T> x = linalg_detail::right_hand_side<T>(b, size());
+			solve_in_place(x);
+			return x;
+		}
+		// X = A^-1 X for an n x r matrix X
+		template <typename Alloc>
+		void solve_in_place(matrix<T, Alloc>& x) const {
+			if (x.shape().first != size()) throw std::invalid_argument("Invalid shapes for solving a linear system");
+			if (m_singular) throw std::domain_error("Solving with a singular matrix");
+			const std::size_t n = size(), r = x.shape().second;
+			T* const xd = x.data();
+			for (std::size_t i = 0; i != n; ++i) if (m_pivots[i] != i) std::swap_ranges(xd + i * r, xd + (i + 1) * r, xd + m_pivots[i] * r);
+			linalg_detail::trsm<true, true, false>(n, m_lu.data(), static_cast<std::ptrdiff_t>(n), 1, xd, r, r);
+			linalg_detail::trsm<false, false, false>(n, m_lu.data(), static_cast<std::ptrdiff_t>(n), 1, xd, r, r);
+		}
+
+		T determinant() const {
+			T det = m_sign;
+			for (std::size_t i = 0; i != size(); ++i) det *= m_lu.data()[i * size() + i];
+			return det;
+		}
+		matrix<T> inverse() const {
+			matrix<T> x(size(), size());
+			for (std::size_t i = 0; i != size(); ++i) x.data()[i * size() + i] = T(1);
+			solve_in_place(x);
+			return x;
+		}
+
+	private:
+		void factor() {
+			const std::size_t n = size();
+			T* const a = m_lu.data();
+			m_pivots.resize(n);
+			for (std::size_t k0 = 0; k0 < n; k0 += linalg_detail::block) {
+				const std::size_t k1 = std::min(n, k0 + linalg_detail::block);
+
+				// the panel, columns [k0, k1), unblocked
+				for (std::size_t j = k0; j != k1; ++j) {
+					std::size_t p = j;
+					auto largest = std::abs(a[j * n + j]);
+					for (std::size_t i = j + 1; i != n; ++i) {
+						const auto v = std::abs(a[i * n + j]);
+						if (v > largest) {
+							largest = v;
+							p = i;
+						}
+					}
+					m_pivots[j] = p;
+					if (p != j) { // whole rows, so L's finished columns follow the exchange too
+						std::swap_ranges(a + j * n, a + (j + 1) * n, a + p * n);
+						m_sign = -m_sign;
+					}
+					if (a[j * n + j] == T{}) {
+						m_singular = true;
+						continue;
+					}
+					const T inv = T(1) / a[j * n + j];
+					sched_detail::for_ranges<T>(n - j - 1, [a, n, j, k1, inv](std::size_t first, std::size_t last) {
+						for (std::size_t i = j + 1 + first; i != j + 1 + last; ++i) {
+							T* const ai = a + i * n;
+							const T l = ai[j] *= inv;
+							const T* aj = a + j * n;
+							for (std::size_t c = j + 1; c != k1; ++c) ai[c] -= l * aj[c];
+						}
+					}, k1 - j);
+				}
+				if (k1 == n) break;
+
+				// U12 = L11^-1 A12, then A22 -= L21 U12
+				linalg_detail::trsm<true, true, false>(k1 - k0, a + k0 * n + k0, static_cast<std::ptrdiff_t>(n), 1, a + k0 * n + k1, n - k1, n);
+				linalg_detail::gemm_update<T>(n - k1, n - k1, k1 - k0, T(-1), a + k1 * n + k0, static_cast<std::ptrdiff_t>(n), 1,
+					a + k0 * n + k1, static_cast<std::ptrdiff_t>(n), 1, T(1), a + k1 * n + k1, static_cast<std::ptrdiff_t>(n));
+			}
+		}
+
+		matrix<T> m_lu;
+		std::vector<std::size_t> m_pivots;
+		T m_sign = T(1);
+		bool m_singular = false;
+	};
+
+	/*
+	 * A = L L^H for a Hermitian (symmetric) positive definite A, of which only the lower triangle is read; blocked like lu_decomposition,
+	 * with the trailing update restricted to the lower triangle
+	 * throws std::domain_error when A turns out not to be positive definite
+	 */
+	template <typename T>
+	class cholesky_decomposition {
+	public:
+		static_assert(is_field<T>::value, "cholesky_decomposition needs a field type (floating point, or std::complex of one)");
+		using value_type = T;
+
+		template <typename X, typename = std::enable_if_t<is_matrix<X>::value || is_matrix_view<X>::value>>
+		explicit cholesky_decomposition(const X& a) : m_l(linalg_detail::load<T>(a)) {
+			if (m_l.shape().first != m_l.shape().second) throw std::invalid_argument("cholesky_decomposition requires a square matrix");
+			factor();
+		}
+
+		std::size_t size() const noexcept { return m_l.shape().first; }
+		// L, zero above the diagonal
+		const matrix<T>& lower() const noexcept { return m_l; }
+
+		template <typename B, typename = std::enable_if_t<is_matrix<B>::value || is_matrix_view<B>::value>>
+		matrix<T> solve(const B& b) const {
+			matrix<T> x = linalg_detail::right_hand_side<T>(b, size());
+			solve_in_place(x);
+			return x;
+		}
+		template <typename Alloc>
+		void solve_in_place(matrix<T, Alloc>& x) const {
+			if (x.shape().first != size()) throw std::invalid_argument("Invalid shapes for solving a linear system");
+			const std::size_t n = size(), r = x.shape().second;
+			linalg_detail::trsm<true, false, false>(n, m_l.data(), static_cast<std::ptrdiff_t>(n), 1, x.data(), r, r);
+			linalg_detail::trsm<false, false, true>(n, m_l.data(), 1, static_cast<std::ptrdiff_t>(n), x.data(), r, r); // L^H
+		}
+
+		T determinant() const {
+			T det(1);
+			for (std::size_t i = 0; i != size(); ++i) det *= m_l.data()[i * size() + i];
+			return det * det; // the diagonal of L is real
+		}
+		matrix<T> inverse() const {
+			matrix<T> x(size(), size());
+			for (std::size_t i = 0; i != size(); ++i) x.data()[i * size() + i] = T(1);
+			solve_in_place(x);
+			return x;
+		}
+
+	private:
+		void factor() {
+			using R = linalg_detail::real_t<T>;
+			const std::size_t n = size();
+			T* const a = m_l.data();
+			matrix<T> w;
+			for (std::size_t k0 = 0; k0 < n; k0 += linalg_detail::block) {
+				const std::size_t k1 = std::min(n, k0 + linalg_detail::block), b = k1 - k0;
+
+				// the diagonal block, unblocked
+				for (std::size_t j = k0; j != k1; ++j) {
+					R d = linalg_detail::real(a[j * n + j]);
+					for (std::size_t p = k0; p != j; ++p) d -= std::norm(a[j * n + p]);
+					if (!(d > R(0))) throw std::domain_error("cholesky_decomposition of a matrix that is not positive definite");
+					const R ljj = std::sqrt(d);
+					a[j * n + j] = T(ljj);
+					for (std::size_t i = j + 1; i != k1; ++i) {
+						T sum = a[i * n + j];
+						for (std::size_t p = k0; p != j; ++p) sum -= a[i * n + p] * linalg_detail::conj(a[j * n + p]);
+						a[i * n + j] = sum / ljj;
+					}
+				}
+				if (k1 == n) break;
+
+				// L21 = A21 L11^-H, one row at a time
+				sched_detail::for_ranges<T>(n - k1, [a, n, k0, k1](std::size_t first, std::size_t last) {
+					for (std::size_t i = k1 + first; i != k1 + last; ++i) {
+						T* const ai = a + i * n;
+						for (std::size_t j = k0; j != k1; ++j) {
+							T sum = ai[j];
+							for (std::size_t p = k0; p != j; ++p) sum -= ai[p] * linalg_detail::conj(a[j * n + p]);
+							ai[j] = sum / a[j * n + j];
+						}
+					}
+				}, b * b);
+
+				// A22 -= L21 L21^H on and below the diagonal, a column band at a time
+				const std::size_t rest = n - k1;
+				const T* lh = a + k1 * n + k0; // L21^H by strides (1, n) for real types, a conjugated copy otherwise
+				std::ptrdiff_t rh = 1, ch = static_cast<std::ptrdiff_t>(n);
+				if BHAVESH_CXX17_CONSTEXPR (!std::is_arithmetic<T>::value) {
+					if (w.size() < b * rest) w = matrix<T>(b, rest, uninitialized);
+					for (std::size_t i = 0; i != rest; ++i) for (std::size_t p = 0; p != b; ++p) w.data()[p * rest + i] = linalg_detail::conj(a[(k1 + i) * n + k0 + p]);
+					lh = w.data();
+					rh = static_cast<std::ptrdiff_t>(rest);
+					ch = 1;
+				}
+				const std::size_t band = std::max<std::size_t>(linalg_detail::block, rest / 4);
+				for (std::size_t j0 = 0; j0 < rest; j0 += band) {
+					const std::size_t cols = std::min(band, rest - j0);
+					linalg_detail::gemm_update<T>(rest - j0, cols, b, T(-1), a + (k1 + j0) * n + k0, static_cast<std::ptrdiff_t>(n), 1,
+						lh + static_cast<std::ptrdiff_t>(j0) * ch, rh, ch, T(1), a + (k1 + j0) * n + k1 + j0, static_cast<std::ptrdiff_t>(n));
+				}
+			}
+			for (std::size_t i = 0; i != n; ++i) std::fill(a + i * n + i + 1, a + (i + 1) * n, T{});
+		}
+
+		matrix<T> m_l;
+	};
+
+	/*
+	 * A = QR by Householder reflections for an m x n A with m >= n, blocked: each panel's reflectors are gathered into one block
+	 * reflector I - V T V^H (compact WY), which updates the rest of the matrix with products of panel depth
+	 * Q is kept implicitly as the reflectors; solve gives the least squares solution of A X = B
+	 */
+	template <typename T>
+	class qr_decomposition {
+	public:
+		static_assert(is_field<T>::value, "qr_decomposition needs a field type (floating point, or std::complex of one)");
+		using value_type = T;
+
+		template <typename X, typename = std::enable_if_t<is_matrix<X>::value || is_matrix_view<X>::value>>
+		explicit qr_decomposition(const X& a) : m_qr(linalg_detail::load<T>(a)) {
+			if (m_qr.shape().first < m_qr.shape().second) throw std::invalid_argument("qr_decomposition requires at least as many rows as columns");
+			factor();
+		}
+
+		std::pair<std::size_t, std::size_t> shape() const noexcept { return m_qr.shape(); }
+		// R on and above the diagonal, the reflector vectors below it (their leading 1 implied)
+		const matrix<T>& factors() const noexcept { return m_qr; }
+		// the scalar of each reflector: H_j = I - tau_j v_j v_j^H
+		const std::vector<T>& tau() const noexcept { return m_tau; }
+
+		// the n x n upper triangular R
+		matrix<T> r() const {
+			const std::size_t n = shape().second;
+			matrix<T> result(n, n);
+			for (std::size_t i = 0; i != n; ++i) std::copy(m_qr.data() + i * n + i, m_qr.data() + (i + 1) * n, result.data() + i * n + i);
+			return result;
+		}
+		// the m x n Q with orthonormal columns (A = QR)
+		matrix<T> q() const {
+			const std::size_t m = shape().first, n = shape().second;
+			matrix<T> result(m, n);
+			for (std::size_t i = 0; i != n; ++i) result.data()[i * n + i] = T(1);
+			for (std::size_t k0 = n ? (n - 1) / linalg_detail::block * linalg_detail::block : 0; n; k0 -= linalg_detail::block) { // last panel first
+				reflector(k0, std::min(n, k0 + linalg_detail::block)).apply(result.data() + k0 * n + k0, n - k0, n, false);
+				if (!k0) break;
+			}
+			return result;
+		}
+
+		// the X minimizing ||A X - B|| (the solution when A is square and nonsingular); throws std::domain_error if R is singular
+		template <typename Alloc = BHAVESH_MATRIX_DEFAULT_ALLOCATOR, typename B, typename = std::enable_if_t<is_matrix<B>::value || is_matrix_view<B>::value>>
+		matrix<T, Alloc> solve(const B& b) const {
+			const std::size_t m = shape().first, n = shape().second;
+			matrix<T> y = linalg_detail::right_hand_side<T>(b, m);
+			const std::size_t r = y.shape().second;
+			for (std::size_t k0 = 0; k0 < n; k0 += linalg_detail::block) reflector(k0, std::min(n, k0 + linalg_detail::block)).apply(y.data() + k0 * r, r, r, true);
+			for (std::size_t i = 0; i != n; ++i) if (m_qr.data()[i * n + i] == T{}) throw std::domain_error("Solving with a rank deficient matrix");
+			matrix<T, Alloc> x(n, r, uninitialized);
+			std::copy(y.data(), y.data() + n * r, x.data());
+			linalg_detail::trsm<false, false, false>(n, m_qr.data(), static_cast<std::ptrdiff_t>(n), 1, x.data(), r, r);
+			return x;
+		}
+
+	private:
+		linalg_detail::block_reflector<T> reflector(std::size_t k0, std::size_t k1) const {
+			return linalg_detail::block_reflector<T>(m_qr.data(), shape().first, shape().second, m_tau.data(), k0, k1 - k0);
+		}
+
+		void factor() {
+			using R = linalg_detail::real_t<T>;
+			const std::size_t m = shape().first, n = shape().second;
+			T* const a = m_qr.data();
+			m_tau.assign(n, T{});
+			std::vector<T> w(linalg_detail::block);
+			for (std::size_t k0 = 0; k0 < n; k0 += linalg_detail::block) {
+				const std::size_t k1 = std::min(n, k0 + linalg_detail::block);
+
+				// the panel, columns [k0, k1), one reflector at a time
+				for (std::size_t j = k0; j != k1; ++j) {
+					const T alpha = a[j * n + j];
+					R xnorm2(0);
+					for (std::size_t i = j + 1; i != m; ++i) xnorm2 += std::norm(a[i * n + j]);
+					if (xnorm2 == R(0) && linalg_detail::imag(alpha) == R(0)) continue; // H_j = I
+					const R beta = -std::copysign(std::sqrt(std::norm(alpha) + xnorm2), linalg_detail::real(alpha));
+					const T tau = (T(beta) - alpha) / T(beta);
+					const T scale = T(1) / (alpha - T(beta));
+					for (std::size_t i = j + 1; i != m; ++i) a[i * n + j] *= scale;
+					a[j * n + j] = T(beta);
+					m_tau[j] = tau;
+
+					// columns (j, k1) -= conj(tau) v (v^H A)
+					const std::size_t cols = k1 - j - 1;
+					if (!cols) continue;
+					std::copy(a + j * n + j + 1, a + j * n + k1, w.begin());
+					for (std::size_t i = j + 1; i != m; ++i) {
+						const T vi = linalg_detail::conj(a[i * n + j]);
+						for (std::size_t c = 0; c != cols; ++c) w[c] += vi * a[i * n + j + 1 + c];
+					}
+					const T ctau = linalg_detail::conj(tau);
+					for (std::size_t c = 0; c != cols; ++c) a[j * n + j + 1 + c] -= ctau * w[c];
+					for (std::size_t i = j + 1; i != m; ++i) {
+						const T vi = ctau * a[i * n + j];
+						for (std::size_t c = 0; c != cols; ++c) a[i * n + j + 1 + c] -= vi * w[c];
+					}
+				}
+				if (k1 == n) break;
+
+				reflector(k0, k1).apply(a + k0 * n + k1, n - k1, n, true);
+			}
+		}
+
+		matrix<T> m_qr;
+		std::vector<T> m_tau;
+	};
+
+#if BHAVESH_CXX17
+	// integer matrices are factored in double
+	template <typename U, typename Alloc> lu_decomposition(const matrix<U, Alloc>&) -> lu_decomposition<std::conditional_t<std::is_integral<U>::value, double, U>>;
+	template <typename U, typename Alloc> cholesky_decomposition(const matrix<U, Alloc>&) -> cholesky_decomposition<std::conditional_t<std::is_integral<U>::value, double, U>>;
+	template <typename U, typename Alloc> qr_decomposition(const matrix<U, Alloc>&) -> qr_decomposition<std::conditional_t<std::is_integral<U>::value, double, U>>;
+#endif
+
+	inline namespace detail {
+	namespace linalg_detail {
+		template <typename T, typename Alloc, typename A, typename B>
+		matrix<T, Alloc> solve(const A& a, const B& b) {
+			static_assert(is_field<T>::value, "solve needs a field or integer element type");
+			const std::size_t m = a.shape().first, n = a.shape().second;
+			if (m == n) {
+				matrix<T, Alloc> x = right_hand_side<T, Alloc>(b, n);
+				lu_decomposition<T>(a).solve_in_place(x);
+				return x;
+			}
+			if (m > n) return qr_decomposition<T>(a).template solve<Alloc>(b);
+			throw std::invalid_argument("solve requires a matrix with at least as many rows as columns");
+		}
+
+		template <typename T, typename Alloc, typename A>
+		matrix<T, Alloc> inverse(const A& a) {
+			static_assert(is_field<T>::value, "inverse needs a field or integer element type");
+			const std::size_t n = a.shape().first;
+			if (a.shape().second != n) throw std::invalid_argument("inverse requires a square matrix");
+			matrix<T, Alloc> x(n, n);
+			for (std::size_t i = 0; i != n; ++i) x.data()[i * n + i] = T(1);
+			lu_decomposition<T>(a).solve_in_place(x);
+			return x;
+		}
+
+		// overflow-checked arithmetic on the wide type of exact_determinant; minors can outgrow the element type long before the result does
+		using exact_t = std::intmax_t;
+		inline exact_t checked_mul(exact_t x, exact_t y) {
+			constexpr exact_t hi = std::numeric_limits<exact_t>::max(), lo = std::numeric_limits<exact_t>::min();
+			if (x > 0 ? (y > 0 ? x > hi / y : y < lo / x) : (y > 0 ? x < lo / y : x != 0 && y < hi / x)) throw std::overflow_error("determinant: intermediate minor overflows intmax_t");
+			return x * y;
+		}
+		inline exact_t checked_sub(exact_t x, exact_t y) {
+			constexpr exact_t hi = std::numeric_limits<exact_t>::max(), lo = std::numeric_limits<exact_t>::min();
+			if (y < 0 ? x > hi + y : x < lo + y) throw std::overflow_error("determinant: intermediate minor overflows intmax_t");
+			return x - y;
+		}
+
+		// Bareiss' fraction-free elimination: every intermediate is a minor of the input, and every division is exact
+		// the minors are carried in intmax_t with checked products, and the result is narrowed back to T only if it fits
+		template <typename T, typename A>
+		T exact_determinant(const A& a) {
+			const std::size_t n = a.shape().first;
+			matrix<exact_t> w = load<exact_t>(a);
+			exact_t* const d = w.data();
+			if constexpr (std::numeric_limits<T>::digits > std::numeric_limits<exact_t>::digits) { // e.g. uint64 elements past intmax_t
+				const auto s = view_detail::strides(a);
+				for (std::size_t i = 0; i != n; ++i) {
+					for (std::size_t j = 0; j != n; ++j) {
+						if (a.data()[static_cast<std::ptrdiff_t>(i) * s.first + static_cast<std::ptrdiff_t>(j) * s.second] > static_cast<T>(std::numeric_limits<exact_t>::max())) {
+							throw std::overflow_error("determinant: element does not fit intmax_t");
+						}
+					}
+				}
+			}
+			exact_t previous = 1;
+			bool negate = false;
+			for (std::size_t k = 0; k + 1 < n; ++k) {
+				if (d[k * n + k] == 0) {
+					std::size_t p = k + 1;
+					while (p != n && d[p * n + k] == 0) ++p;
+					if (p == n) return T(0);
+					std::swap_ranges(d + k * n, d + (k + 1) * n, d + p * n);
+					negate = !negate;
+				}
+				const exact_t pivot = d[k * n + k];
+				for (std::size_t i = k + 1; i != n; ++i) {
+					for (std::size_t j = k + 1; j != n; ++j) d[i * n + j] = checked_sub(checked_mul(d[i * n + j], pivot), checked_mul(d[i * n + k], d[k * n + j])) / previous;
+				}
+				previous = pivot;
+			}
+			exact_t det = n ? d[n * n - 1] : 1;
+			if (negate) det = checked_sub(0, det);
+			const bool fits = std::is_signed<T>::value
+				? det >= static_cast<exact_t>(std::numeric_limits<T>::min()) && (std::numeric_limits<T>::digits >= std::numeric_limits<exact_t>::digits || det <= static_cast<exact_t>(std::numeric_limits<T>::max()))
+				: det >= 0 && (std::numeric_limits<T>::digits >= std::numeric_limits<exact_t>::digits || det <= static_cast<exact_t>(std::numeric_limits<T>::max()));
+			if (!fits) throw std::overflow_error("determinant does not fit the element type");
+			return static_cast<T>(det);
+		}
+
+		template <typename T, typename A>
+		T determinant(const A& a) {
+			if (a.shape().first != a.shape().second) throw std::invalid_argument("determinant requires a square matrix");
+			if constexpr (std::is_integral<T>::value) return exact_determinant<T>(a);
+			else {
+				static_assert(is_field<T>::value, "determinant needs a field or integer element type");
+				return lu_decomposition<T>(a).determinant();
+			}
+		}
+	}
+	}
+
+	// X with A X = B (least squares for tall A); A and B are matrices or views
+	template <typename A, typename B, typename = std::enable_if_t<(is_matrix<A>::value || is_matrix_view<A>::value) && (is_matrix<B>::value || is_matrix_view<B>::value)>>
+	matrix<linalg_detail::field_t<std::remove_cv_t<typename A::value_type>>> solve(const A& a, const B& b) {
+		return linalg_detail::solve<linalg_detail::field_t<std::remove_cv_t<typename A::value_type>>, BHAVESH_MATRIX_DEFAULT_ALLOCATOR>(a, b);
+	}
+	template <typename A, typename = std::enable_if_t<is_matrix<A>::value || is_matrix_view<A>::value>>
+	matrix<linalg_detail::field_t<std::remove_cv_t<typename A::value_type>>> inverse(const A& a) {
+		return linalg_detail::inverse<linalg_detail::field_t<std::remove_cv_t<typename A::value_type>>, BHAVESH_MATRIX_DEFAULT_ALLOCATOR>(a);
+	}
+	// integer element types are exact (fraction-free elimination); std::overflow_error if the determinant does not fit the element type
+	template <typename A, typename = std::enable_if_t<is_matrix<A>::value || is_matrix_view<A>::value>>
+	std::remove_cv_t<typename A::value_type> determinant(const A& a) {
+		return linalg_detail::determinant<std::remove_cv_t<typename A::value_type>>(a);
+	}
+
+}
+
+#endif // !BHAVESH_MATRIX_LINALG_H
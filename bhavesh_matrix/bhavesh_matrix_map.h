@@ -0,0 +1,308 @@
+#ifndef BHAVESH_MATRIX_MAP_H
+#define BHAVESH_MATRIX_MAP_H 0.1
+
+#include "bhavesh_matrix_v1.h"
+
+namespace bhavesh {
+
+	inline namespace detail {
+	namespace map_detail {
+		/*
+		 * elementwise maps with user functors
+		 * every operand is seen as a grid: element (i, j) lives at p[i * rs + j * cs]. broadcasting stretches an extent of 1 to the
+		 * other operand's extent by giving it stride 0, so a row (1 x n) repeats down the rows and a column (m x 1) across the columns
+		 * without being copied. a grid whose operands are all densely packed runs as one flat range cut into contiguous chunks,
+		 * contiguous rows run as bands of rows, anything else (transposed views) tile by tile. the functor is a template parameter
+		 * of the innermost loops, so it is inlined and vectorized in each of their per-isa builds (see simd_detail::make_kernel_table)
+		 */
+
+		template <typename T>
+		struct grid {
+			T* p;
+			std::size_t m, n;
+			std::ptrdiff_t rs, cs;
+
+			T& operator()(std::size_t i, std::size_t j) const { return p[static_cast<std::ptrdiff_t>(i) * rs + static_cast<std::ptrdiff_t>(j) * cs]; }
+			T* row(std::size_t i) const { return p + static_cast<std::ptrdiff_t>(i) * rs; }
+			operator grid<const T>() const { return { p, m, n, rs, cs }; }
+		};
+
+		// strides that cannot matter (a single row or column) are normalized so that layouts compare equal
+		template <typename T>
+		grid<T> make_grid(T* p, std::size_t m, std::size_t n, std::ptrdiff_t rs, std::ptrdiff_t cs) {
+			if (n == 1) cs = 1;
+			if (m == 1) rs = static_cast<std::ptrdiff_t>(n) * cs;
+			return { p, m, n, rs, cs };
+		}
+
+		template <typename X>
+		using is_operand = std::integral_constant<bool, is_matrix<X>::value || is_matrix_view<X>::value || is_vector_operand<X>::value>;
+
+		template <typename> struct is_row : std::false_type {};
+		template <typename T> struct is_row<matrix_row<T>> : std::true_type {};
+
+		// matrices and views as they are laid out; a matrix_row is 1 x n, a matrix_column and a dense_vector are n x 1
+		template <typename X, std::enable_if_t<is_matrix<std::remove_cv_t<X>>::value || is_matrix_view<std::remove_cv_t<X>>::value, int> = 0>
+		auto grid_of(X& x) {
+			const auto s = view_detail::strides(x);
+			return make_grid(x.data(), x.shape().first, x.shape().second, s.first, s.second);
+		}
+		template <typename X, std::enable_if_t<is_vector_operand<std::remove_cv_t<X>>::value && is_row<std::remove_cv_t<X>>::value, int> = 0>
+		auto grid_of(X& x) {
+			return make_grid(x.data(), 1, x.size(), static_cast<std::ptrdiff_t>(x.size()), 1);
+		}
+		template <typename X, std::enable_if_t<is_vector_operand<std::remove_cv_t<X>>::value && !is_row<std::remove_cv_t<X>>::value, int> = 0>
+		auto grid_of(X& x) {
+			return make_grid(x.data(), x.size(), 1, vector_detail::stride(x), 1);
+		}
+
+		template <typename X>
+		using element_t = std::remove_cv_t<std::remove_pointer_t<decltype(std::declval<const X&>().data())>>;
+
+		// extent of a broadcast dimension: equal extents, or one of them 1
+		inline std::size_t common_extent(std::size_t a, std::size_t b) {
+			if (a != b && a != 1 && b != 1) throw std::invalid_argument("Shapes of the operands cannot be broadcast together");
+			return a == 1 ? b : a;
+		}
+
+		// g read as an m x n grid: an extent of 1 repeats (stride 0), any other extent has to match already
+		template <typename T>
+		grid<T> stretch(grid<T> g, std::size_t m, std::size_t n) {
+			if (g.m != m) {
+				if (g.m != 1) throw std::invalid_argument("Shapes of the operands cannot be broadcast together");
+				g.m = m;
+				g.rs = 0;
+			}
+			if (g.n != n) {
+				if (g.n != 1) throw std::invalid_argument("Shapes of the operands cannot be broadcast together");
+				g.n = n;
+				g.cs = 0;
+			}
+			return g;
+		}
+
+		// [lowest, one past highest) address a grid touches; strides are never negative
+		template <typename T>
+		std::pair<const void*, const void*> footprint(const grid<T>& g) {
+			if (g.m == 0 || g.n == 0) return { nullptr, nullptr };
+			return { g.p, g.p + static_cast<std::ptrdiff_t>(g.m - 1) * g.rs + static_cast<std::ptrdiff_t>(g.n - 1) * g.cs + 1 };
+		}
+		template <typename T, typename U>
+		bool overlap(const grid<T>& a, const grid<U>& b) {
+			const auto fa = footprint(a), fb = footprint(b);
+			return fa.first && fb.first && std::less<const void*>{}(fa.first, fb.second) && std::less<const void*>{}(fb.first, fa.second);
+		}
+
+		/*
+		 * the innermost loops: out[j] = f(a[j * ca]) or f(a[j * ca], b[j * cb]) for j < s, where each input stride is 1 or 0 (an element
+		 * repeated by broadcasting); every combination gets its own loop so that f sees plain unit-stride reads or a loop invariant
+		 * out is written by construction: it is raw storage of a trivially copyable R, or live trivially copyable elements being
+		 * overwritten in place (out may then be a itself)
+		 */
+#		define BHAVESH_MAP_KERNELS(isa, target) \
+		template <typename R, typename F, typename A> \
+		target void isa##_map(R* out, std::size_t s, F& f, const A* a, std::ptrdiff_t ca) { \
+			if (ca == 1) { \
+				for (std::size_t j = 0; j != s; ++j) (matrix_detail::construct_at)(out + j, static_cast<R>(f(a[j]))); \
+				return; \
+			} \
+			const A& x = *a; \
+			for (std::size_t j = 0; j != s; ++j) (matrix_detail::construct_at)(out + j, static_cast<R>(f(x))); \
+		} \
+		template <typename R, typename F, typename A, typename B> \
+		target void isa##_zip(R* out, std::size_t s, F& f, const A* a, std::ptrdiff_t ca, const B* b, std::ptrdiff_t cb) { \
+			if (ca == 1 && cb == 1) { \
+				for (std::size_t j = 0; j != s; ++j) (matrix_detail::construct_at)(out + j, static_cast<R>(f(a[j], b[j]))); \
+			} \
+			else if (ca == 1) { \
+				const B& y = *b; \
+				for (std::size_t j = 0; j != s; ++j) (matrix_detail::construct_at)(out + j, static_cast<R>(f(a[j], y))); \
+			} \
+			else if (cb == 1) { \
+				const A& x = *a; \
+				for (std::size_t j = 0; j != s; ++j) (matrix_detail::construct_at)(out + j, static_cast<R>(f(x, b[j]))); \
+			} \
+			else { \
+				const A& x = *a; \
+				const B& y = *b; \
+				for (std::size_t j = 0; j != s; ++j) (matrix_detail::construct_at)(out + j, static_cast<R>(f(x, y))); \
+			} \
+		}
+
+		BHAVESH_MAP_KERNELS(scalar, )
+#	if BHAVESH_MATRIX_X86_SIMD
+		BHAVESH_MAP_KERNELS(avx2, BHAVESH_TARGET_AVX2)
+		BHAVESH_MAP_KERNELS(avx512, BHAVESH_TARGET_AVX512)
+#	endif
+#	undef BHAVESH_MAP_KERNELS
+
+		// element types the isa-specific loops are stamped out for; anything else runs the plain ones
+		template <typename... T>
+		struct has_kernels : std::integral_constant<bool, std::conjunction<std::is_arithmetic<T>...>::value> {};
+
+		template <typename R, typename F, typename A>
+		struct map_table { void (*run)(R*, std::size_t, F&, const A*, std::ptrdiff_t); };
+		template <typename R, typename F, typename A, typename B>
+		struct zip_table { void (*run)(R*, std::size_t, F&, const A*, std::ptrdiff_t, const B*, std::ptrdiff_t); };
+
+		template <typename R, typename F, typename A>
+		inline map_table<R, F, A> make_map_table(simd_detail::isa_t isa) {
+			switch (isa) {
+#	if BHAVESH_MATRIX_X86_SIMD
+			case simd_detail::isa_t::avx512: return { avx512_map<R, F, A> };
+			case simd_detail::isa_t::avx2:   return { avx2_map  <R, F, A> };
+#	endif
+			default:                         return { scalar_map<R, F, A> };
+			}
+		}
+		template <typename R, typename F, typename A, typename B>
+		inline zip_table<R, F, A, B> make_zip_table(simd_detail::isa_t isa) {
+			switch (isa) {
+#	if BHAVESH_MATRIX_X86_SIMD
+			case simd_detail::isa_t::avx512: return { avx512_zip<R, F, A, B> };
+			case simd_detail::isa_t::avx2:   return { avx2_zip  <R, F, A, B> };
+#	endif
+			default:                         return { scalar_zip<R, F, A, B> };
+			}
+		}
+
+		// where a run of an input starts and whether it moves along (inc 1) or repeats one element (inc 0)
+		template <typename T>
+		struct cursor {
+			T* p;
+			std::ptrdiff_t inc;
+		};
+
+		// one contiguous run of s outputs
+		template <typename R, typename F, typename A>
+		inline void run(R* out, std::size_t s, F& f, cursor<const A> x) {
+			const A* a = x.p;
+			const std::ptrdiff_t ca = x.inc;
+			if BHAVESH_CXX17_CONSTEXPR(has_kernels<R, A>::value) {
+				static const map_table<R, F, A> table = map_detail::make_map_table<R, F, A>(simd_detail::active_isa());
+				table.run(out, s, f, a, ca);
+			}
+			else scalar_map<R, F, A>(out, s, f, a, ca);
+		}
+		template <typename R, typename F, typename A, typename B>
+		inline void run(R* out, std::size_t s, F& f, cursor<const A> x, cursor<const B> y) {
+			const A* a = x.p;
+			const B* b = y.p;
+			const std::ptrdiff_t ca = x.inc, cb = y.inc;
+			if BHAVESH_CXX17_CONSTEXPR(has_kernels<R, A, B>::value) {
+				static const zip_table<R, F, A, B> table = map_detail::make_zip_table<R, F, A, B>(simd_detail::active_isa());
+				table.run(out, s, f, a, ca, b, cb);
+			}
+			else scalar_zip<R, F, A, B>(out, s, f, a, ca, b, cb);
+		}
+
+		// packed in row-major order (or one element repeated everywhere), so that element (i, j) is p[(i * n + j) * cs]
+		template <typename T>
+		bool dense(const grid<T>& g) {
+			return (g.cs == 1 && g.rs == static_cast<std::ptrdiff_t>(g.n)) || (g.cs == 0 && g.rs == 0);
+		}
+
+		/*
+		 * out(i, j) = f(x(i, j)...) over out's extent, the inputs already stretched to it; f may be called concurrently from the
+		 * scheduler's threads. trivially copyable elements of out are constructed (out may be raw storage), anything else is assigned
+		 */
+		template <typename R, typename F, typename... T>
+		void for_grid(const grid<R>& out, F& f, const grid<T>&... x) {
+			const std::size_t m = out.m, n = out.n;
+			if (m == 0 || n == 0) return;
+			if BHAVESH_CXX17_CONSTEXPR(std::is_trivially_copyable<R>::value) {
+				if (dense(out) && (dense(x) && ...)) {
+					sched_detail::for_ranges<R>(m * n, [&out, &f, &x...](std::size_t first, std::size_t last) {
+						map_detail::run(out.p + first, last - first, f, cursor<const T>{ x.p + static_cast<std::ptrdiff_t>(first) * x.cs, x.cs }...);
+					});
+					return;
+				}
+				if (out.cs == 1 && ((x.cs == 1 || x.cs == 0) && ...)) {
+					sched_detail::for_ranges<R>(m, [&out, &f, &x..., n](std::size_t first, std::size_t last) {
+						for (std::size_t i = first; i != last; ++i) map_detail::run(out.row(i), n, f, cursor<const T>{ x.row(i), x.cs }...);
+					}, n);
+					return;
+				}
+				view_detail::for_each_blocked(m, n, [&out, &f, &x...](std::size_t i, std::size_t j) { (matrix_detail::construct_at)(&out(i, j), static_cast<R>(f(x(i, j)...))); });
+			}
+			else {
+				view_detail::for_each_blocked(m, n, [&out, &f, &x...](std::size_t i, std::size_t j) { out(i, j) = static_cast<R>(f(x(i, j)...)); });
+			}
+		}
+
+		// a new m x n matrix of f(x(i, j)...), built in a construction_holder: trivially copyable results are constructed in place by
+		// for_grid (nothing is committed, and so nothing destroyed, if f throws), anything else one element after another
+		template <typename R, typename F, typename... T>
+		matrix<R> build(std::size_t m, std::size_t n, F& f, const grid<T>&... x) {
+			matrix_detail::construction_holder<R> h(m, n);
+			if BHAVESH_CXX17_CONSTEXPR(std::is_trivially_copyable<R>::value) {
+				for_grid(grid<R>{ h.uninitialized_data(), m, n, static_cast<std::ptrdiff_t>(n), 1 }, f, x...);
+				h.commit(m * n);
+			}
+			else {
+				for (std::size_t i = 0; i != m; ++i) {
+					for (std::size_t j = 0; j != n; ++j) h.emplace_back(f(x(i, j)...));
+				}
+			}
+			return matrix<R>(matrix_take_ownership, h.release<true>(), m, n);
+		}
+
+		template <typename F, typename... X>
+		using result_t = std::decay_t<decltype(std::declval<F&>()(std::declval<const element_t<X>&>()...))>;
+
+		template <typename... X>
+		using enable_if_operands = std::enable_if_t<std::conjunction<is_operand<std::remove_cv_t<std::remove_reference_t<X>>>...>::value>;
+	}
+	}
+
+	/*
+	 * elementwise maps with any functor: map(x, f) is the matrix of f(x(i, j)), zip(a, b, f) the matrix of f(a(i, j), b(i, j)), and
+	 * map_inplace / zip_inplace write the results back into x (a matrix, or a view into one)
+	 * operands are matrices, views, rows and columns of matrices and dense_vectors (an n x 1 column; as_row() makes it 1 x n). zip
+	 * broadcasts: an extent of 1 repeats along that dimension, so zip(A, b.as_row(), f) applies b to every row of A and
+	 * zip(A, A.column(0), f) the first column to every column; the result takes the larger extents
+	 * f is inlined into the loops and is called concurrently on large operands, so it must not depend on the order of the calls;
+	 * as the loops are compiled for the cpu they run on, floating point expressions in f may be contracted into fused multiply-adds
+	 */
+
+	template <typename X, typename F, typename = map_detail::enable_if_operands<X>>
+	matrix<map_detail::result_t<F, X>> map(const X& x, F f) {
+		const auto g = map_detail::grid_of(x);
+		return map_detail::build<map_detail::result_t<F, X>>(g.m, g.n, f, g);
+	}
+
+	// throws std::invalid_argument when the shapes cannot be broadcast together
+	template <typename A, typename B, typename F, typename = map_detail::enable_if_operands<A, B>>
+	matrix<map_detail::result_t<F, A, B>> zip(const A& a, const B& b, F f) {
+		const auto ga = map_detail::grid_of(a);
+		const auto gb = map_detail::grid_of(b);
+		const std::size_t m = map_detail::common_extent(ga.m, gb.m), n = map_detail::common_extent(ga.n, gb.n);
+		return map_detail::build<map_detail::result_t<F, A, B>>(m, n, f, map_detail::stretch(ga, m, n), map_detail::stretch(gb, m, n));
+	}
+
+	template <typename X, typename F, typename = map_detail::enable_if_operands<X>>
+	void map_inplace(X&& x, F f) {
+		const auto g = map_detail::grid_of(x);
+		static_assert(!std::is_const<std::remove_reference_t<decltype(*g.p)>>::value, "map_inplace needs writable elements");
+		map_detail::for_grid(g, f, map_detail::grid<const map_detail::element_t<std::remove_reference_t<X>>>(g));
+	}
+
+	// x(i, j) = f(x(i, j), b(i, j)) with b broadcast to x's shape (never the other way round); b may be part of x
+	template <typename X, typename B, typename F, typename = map_detail::enable_if_operands<X, B>>
+	void zip_inplace(X&& x, const B& b, F f) {
+		const auto g = map_detail::grid_of(x);
+		static_assert(!std::is_const<std::remove_reference_t<decltype(*g.p)>>::value, "zip_inplace needs writable elements");
+		using TX = map_detail::element_t<std::remove_reference_t<X>>;
+		using TB = map_detail::element_t<B>;
+		const auto gb = map_detail::stretch(map_detail::grid_of(b), g.m, g.n);
+		if (map_detail::overlap(g, gb) && !(static_cast<const void*>(gb.p) == g.p && gb.rs == g.rs && gb.cs == g.cs)) {
+			// b would be overwritten while it is still being read (a row of x applied to every row of x): read a copy instead
+			const matrix<TB> copy = bhavesh::map(b, [](const TB& v) { return v; });
+			map_detail::for_grid(g, f, map_detail::grid<const TX>(g), map_detail::stretch(map_detail::grid_of(copy), g.m, g.n));
+			return;
+		}
+		map_detail::for_grid(g, f, map_detail::grid<const TX>(g), gb);
+	}
+}
+
+#endif // !BHAVESH_MATRIX_MAP_H
@@ -0,0 +1,455 @@
+#ifndef BHAVESH_MATRIX_OUT_OF_CORE_H
+#define BHAVESH_MATRIX_OUT_OF_CORE_H 0.1
+
+#include "bhavesh_matrix_io.h"
+
+#include <list> // panel lru order
+#include <memory> // shared panels
+#include <cerrno> // EINTR
+
+#if !defined(_WIN32)
+# include <sys/types.h> // off_t
+#endif
+
+#ifndef BHAVESH_MATRIX_PANEL_BYTES
+# define BHAVESH_MATRIX_PANEL_BYTES (std::size_t(1) << 25) // default height of a panel: as many rows as fit in this many bytes
+#endif
+#ifndef BHAVESH_MATRIX_CACHED_PANELS
+# define BHAVESH_MATRIX_CACHED_PANELS 4 // default number of panels kept in memory per out-of-core matrix
+#endif
+
+namespace bhavesh {
+
+	inline namespace detail {
+	namespace ooc_detail {
+		// positional reads and writes, safe to issue from several threads at once
+		// sizes and offsets are 64 bit on every target: a 32 bit build still streams files past 4 GB (off_t must be 64 bit there, see to_off)
+		class file {
+		public:
+			file(const std::string& path, bool create) : m_path(path) {
+#			if defined(_WIN32)
+				m_handle = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, create ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+				if (m_handle == INVALID_HANDLE_VALUE) {
+					// fall back to read-only so files on read-only media can still be streamed
+					if (!create) m_handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+					if (m_handle == INVALID_HANDLE_VALUE) throw file_detail::error(path, "could not be opened");
+				}
+#			else
+				m_fd = ::open(path.c_str(), create ? O_RDWR | O_CREAT | O_TRUNC : O_RDWR, 0644);
+				if (m_fd < 0 && !create) m_fd = ::open(path.c_str(), O_RDONLY);
+				if (m_fd < 0) throw file_detail::error(path, "could not be opened");
+#			endif
+			}
+			file(const file&) = delete;
+			file& operator=(const file&) = delete;
+			~file() {
+#			if defined(_WIN32)
+				CloseHandle(m_handle);
+#			else
+				::close(m_fd);
+#			endif
+			}
+
+			std::uint64_t size() const {
+#			if defined(_WIN32)
+				LARGE_INTEGER size;
+				if (!GetFileSizeEx(m_handle, &size)) throw file_detail::error(m_path, "could not be sized");
+				return static_cast<std::uint64_t>(size.QuadPart);
+#			else
+				struct stat st;
+				if (::fstat(m_fd, &st) != 0) throw file_detail::error(m_path, "could not be sized");
+				return static_cast<std::uint64_t>(st.st_size);
+#			endif
+			}
+			void resize(std::uint64_t bytes) {
+#			if defined(_WIN32)
+				LARGE_INTEGER end;
+				end.QuadPart = static_cast<LONGLONG>(bytes);
+				if (!SetFilePointerEx(m_handle, end, nullptr, FILE_BEGIN) || !SetEndOfFile(m_handle)) throw file_detail::error(m_path, "could not be resized");
+#			else
+				if (::ftruncate(m_fd, to_off(bytes)) != 0) throw file_detail::error(m_path, "could not be resized");
+#			endif
+			}
+
+			void read(void* dst, std::size_t bytes, std::uint64_t offset) const {
+				char* p = static_cast<char*>(dst);
+				while (bytes) {
+#				if defined(_WIN32)
+					OVERLAPPED at{};
+					at.Offset = static_cast<DWORD>(offset);
+					at.OffsetHigh = static_cast<DWORD>(offset >> 32);
+					DWORD got = 0;
+					if (!ReadFile(m_handle, p, static_cast<DWORD>(bytes < (1u << 30) ? bytes : (1u << 30)), &got, &at) || got == 0) throw file_detail::error(m_path, "read failed");
+#				else
+					const ::ssize_t got = ::pread(m_fd, p, bytes, to_off(offset));
+					if (got < 0 && errno == EINTR) continue;
+					if (got <= 0) throw file_detail::error(m_path, "read failed");
+#				endif
+					p += got;
+					bytes -= static_cast<std::size_t>(got);
+					offset += static_cast<std::uint64_t>(got);
+				}
+			}
+			void write(const void* src, std::size_t bytes, std::uint64_t offset) {
+				const char* p = static_cast<const char*>(src);
+				while (bytes) {
+#				if defined(_WIN32)
+					OVERLAPPED at{};
+					at.Offset = static_cast<DWORD>(offset);
+					at.OffsetHigh = static_cast<DWORD>(offset >> 32);
+					DWORD put = 0;
+					if (!WriteFile(m_handle, p, static_cast<DWORD>(bytes < (1u << 30) ? bytes : (1u << 30)), &put, &at) || put == 0) throw file_detail::error(m_path, "write failed");
+#				else
+					const ::ssize_t put = ::pwrite(m_fd, p, bytes, to_off(offset));
+					if (put < 0 && errno == EINTR) continue;
+					if (put <= 0) throw file_detail::error(m_path, "write failed");
+#				endif
+					p += put;
+					bytes -= static_cast<std::size_t>(put);
+					offset += static_cast<std::uint64_t>(put);
+				}
+			}
+
+		private:
+#		if !defined(_WIN32)
+			// a 32 bit off_t (no _FILE_OFFSET_BITS=64) cannot address past 2 GB; refuse rather than wrap
+			off_t to_off(std::uint64_t x) const {
+				if (x > static_cast<std::uint64_t>(std::numeric_limits<off_t>::max())) throw file_detail::error(m_path, "offset beyond what off_t can address; build with _FILE_OFFSET_BITS=64");
+				return static_cast<off_t>(x);
+			}
+#		endif
+
+			std::string m_path;
+#		if defined(_WIN32)
+			HANDLE m_handle;
+#		else
+			int m_fd;
+#		endif
+		};
+
+		/*
+		 * the row panels of one file and the bounded cache in front of them
+		 * a panel is a slot while it is being read (others asking for it wait) and sits in the lru list once it is ready;
+		 * evicting only drops the cache's reference, so a panel somebody still holds stays valid until they let go of it
+		 * prefetches are served by one background thread, started on the first prefetch
+		 */
+		template <typename T>
+		class panel_store {
+		public:
+			using panel = std::shared_ptr<const matrix<T>>;
+
+			panel_store(const std::string& path, bool create, std::size_t rows, std::size_t cols, std::size_t panel_rows, std::size_t capacity) : m_file(path, create) {
+				if (create) {
+					char page[file_detail::header_bytes];
+					file_detail::make_header<T>(page, rows, cols);
+					m_file.write(page, sizeof(page), 0);
+					m_file.resize(file_detail::header_bytes + std::uint64_t(rows) * cols * sizeof(T));
+				}
+				else {
+					char page[file_detail::header_bytes];
+					const std::uint64_t bytes = m_file.size();
+					if (bytes < sizeof(page)) throw file_detail::error(path, "too small to hold a header");
+					m_file.read(page, sizeof(page), 0);
+					const matrix_file_info info = file_detail::parse(path, page, bytes);
+					file_detail::check_type<T>(path, info);
+					rows = info.rows;
+					cols = info.cols;
+				}
+				m = rows;
+				n = cols;
+				m_panel_rows = panel_rows ? panel_rows : std::max<std::size_t>(1, BHAVESH_MATRIX_PANEL_BYTES / std::max<std::size_t>(1, n * sizeof(T)));
+				m_capacity = std::max<std::size_t>(2, capacity); // the panel in use and the one being prefetched
+				m_slots.resize(m ? (m - 1) / m_panel_rows + 1 : 0);
+			}
+			panel_store(const panel_store&) = delete;
+			panel_store& operator=(const panel_store&) = delete;
+			~panel_store() {
+				{
+					std::lock_guard<std::mutex> guard(m_lock);
+					m_stop = true;
+				}
+				m_changed.notify_all();
+				if (m_prefetcher.joinable()) m_prefetcher.join();
+			}
+
+			std::size_t rows() const noexcept { return m; }
+			std::size_t cols() const noexcept { return n; }
+			std::size_t panel_rows() const noexcept { return m_panel_rows; }
+			std::size_t panel_count() const noexcept { return m_slots.size(); }
+			std::size_t capacity() const noexcept { return m_capacity; }
+			std::size_t first_row(std::size_t p) const noexcept { return p * m_panel_rows; }
+			std::size_t height(std::size_t p) const noexcept { return std::min(m_panel_rows, m - p * m_panel_rows); }
+
+			panel load(std::size_t p) {
+				std::unique_lock<std::mutex> guard(m_lock);
+				for (;;) {
+					const std::shared_ptr<slot> s = m_slots[p];
+					if (!s) break;
+					if (s->ready) {
+						m_lru.splice(m_lru.begin(), m_lru, s->pos);
+						return s->data;
+					}
+					m_changed.wait(guard); // somebody else is reading it
+				}
+				const std::shared_ptr<slot> s = std::make_shared<slot>();
+				m_slots[p] = s;
+				guard.unlock();
+
+				std::shared_ptr<matrix<T>> data;
+				std::exception_ptr failure;
+				try {
+					data = std::make_shared<matrix<T>>(height(p), n, uninitialized);
+					m_file.read(data->data(), data->size() * sizeof(T), offset(first_row(p)));
+				}
+				catch (...) {
+					failure = std::current_exception();
+				}
+
+				guard.lock();
+				if (m_slots[p] == s) {
+					if (failure) m_slots[p].reset(); // failures are not cached; the next load tries again
+					else {
+						s->data = data;
+						s->ready = true;
+						m_lru.push_front(p);
+						s->pos = m_lru.begin();
+						while (m_lru.size() > m_capacity) {
+							m_slots[m_lru.back()].reset();
+							m_lru.pop_back();
+						}
+					}
+				}
+				guard.unlock();
+				m_changed.notify_all();
+				if (failure) std::rethrow_exception(failure);
+				return data;
+			}
+
+			void prefetch(std::size_t p) {
+				{
+					std::lock_guard<std::mutex> guard(m_lock);
+					if (m_slots[p]) return; // cached or on its way
+					m_requests.push_back(p);
+					if (!m_prefetcher.joinable()) m_prefetcher = std::thread([this] { serve(); });
+				}
+				m_changed.notify_all();
+			}
+
+			// rows [first, first + count) of the file from a row-major buffer; panels that held the old rows are dropped from the cache
+			void store(std::size_t first, std::size_t count, const T* src) {
+				if (!count) return;
+				m_file.write(src, count * n * sizeof(T), offset(first));
+				// after the write, so a read that raced with it can never be handed out again
+				std::lock_guard<std::mutex> guard(m_lock);
+				for (std::size_t p = first / m_panel_rows; p != m_slots.size() && first_row(p) < first + count; ++p) {
+					if (!m_slots[p]) continue;
+					if (m_slots[p]->ready) m_lru.erase(m_slots[p]->pos);
+					m_slots[p].reset();
+				}
+			}
+
+		private:
+			// byte offset of row i in the file, computed in 64 bits so it does not wrap on 32 bit targets
+			std::uint64_t offset(std::size_t i) const noexcept { return file_detail::header_bytes + std::uint64_t(i) * n * sizeof(T); }
+
+			struct slot {
+				std::shared_ptr<const matrix<T>> data;
+				bool ready = false;
+				std::list<std::size_t>::iterator pos;
+			};
+
+			void serve() {
+				std::unique_lock<std::mutex> guard(m_lock);
+				for (;;) {
+					m_changed.wait(guard, [this] { return m_stop || !m_requests.empty(); });
+					if (m_stop) return;
+					const std::size_t p = m_requests.front();
+					m_requests.pop_front();
+					guard.unlock();
+					try {
+						load(p);
+					}
+					catch (...) {} // a failed prefetch is retried, and reported, by the load that needs the panel
+					guard.lock();
+				}
+			}
+
+			file m_file;
+			std::size_t m = 0;
+			std::size_t n = 0;
+			std::size_t m_panel_rows = 1;
+			std::size_t m_capacity = 2;
+
+			std::mutex m_lock;
+			std::condition_variable m_changed;
+			std::vector<std::shared_ptr<slot>> m_slots;
+			std::list<std::size_t> m_lru; // most recently used first
+			std::deque<std::size_t> m_requests;
+			bool m_stop = false;
+			std::thread m_prefetcher;
+		};
+	}
+	}
+
+	/*
+	 * a matrix kept in a matrix file (see bhavesh_matrix_io.h) and brought into memory one row panel at a time
+	 * at most cache_panels panels are cached (least recently used ones are dropped first), so memory use is bounded by the panel height,
+	 * not by the matrix; the streamed operations walk the panels in order and have the next one read on a background thread
+	 * while the current one is being worked on
+	 * operations are thread safe with respect to each other; panels handed out stay valid after they are evicted or overwritten
+	 */
+	template <typename T>
+	class out_of_core_matrix {
+	public:
+		using value_type = T;
+		using panel = std::shared_ptr<const matrix<T>>;
+
+		static_assert(file_detail::dtype_of<T>() != matrix_dtype::unknown, "no matrix file dtype for this element type");
+
+		// an existing file; panel_rows == 0 picks a height of about BHAVESH_MATRIX_PANEL_BYTES
+		explicit out_of_core_matrix(const std::string& path, std::size_t panel_rows = 0, std::size_t cache_panels = BHAVESH_MATRIX_CACHED_PANELS)
+			: m_store(std::make_unique<ooc_detail::panel_store<T>>(path, false, 0, 0, panel_rows, cache_panels)) {}
+
+		// a new zero filled rows x cols file, replacing any file at path
+		static out_of_core_matrix create(const std::string& path, std::size_t rows, std::size_t cols, std::size_t panel_rows = 0, std::size_t cache_panels = BHAVESH_MATRIX_CACHED_PANELS) {
+			return out_of_core_matrix(std::make_unique<ooc_detail::panel_store<T>>(path, true, rows, cols, panel_rows, cache_panels));
+		}
+
+	public: /* shape information */
+		std::pair<std::size_t, std::size_t> shape() const noexcept { return { m_store->rows(), m_store->cols() }; }
+		std::size_t size() const noexcept { return m_store->rows() * m_store->cols(); }
+		std::size_t panel_rows() const noexcept { return m_store->panel_rows(); }
+		std::size_t panel_count() const noexcept { return m_store->panel_count(); }
+		// [first row, rows) of panel p
+		std::pair<std::size_t, std::size_t> panel_extent(std::size_t p) const {
+			check_panel(p);
+			return { m_store->first_row(p), m_store->height(p) };
+		}
+
+	public: /* panels */
+		// panel p (panel_extent(p).second x cols), read now unless it is cached or already being prefetched
+		panel load_panel(std::size_t p) const {
+			check_panel(p);
+			return m_store->load(p);
+		}
+		// starts reading panel p in the background; returns immediately
+		void prefetch(std::size_t p) const {
+			check_panel(p);
+			m_store->prefetch(p);
+		}
+		// writes rows.shape().first rows starting at first_row; rows may be a matrix or any view with cols columns
+		template <typename X, typename = std::enable_if_t<is_matrix<X>::value || is_matrix_view<X>::value>>
+		void store_rows(std::size_t first_row, const X& rows) {
+			if (rows.shape().second != shape().second || first_row > shape().first || rows.shape().first > shape().first - first_row) {
+				throw std::invalid_argument("Invalid shape for a write into an out-of-core matrix");
+			}
+			const auto s = view_detail::strides(rows);
+			if (s.second == 1 && s.first == static_cast<std::ptrdiff_t>(rows.shape().second)) m_store->store(first_row, rows.shape().first, rows.data());
+			else {
+				matrix<T> packed(rows.shape().first, rows.shape().second, uninitialized);
+				matrix_view<T>(packed).assign(rows);
+				m_store->store(first_row, rows.shape().first, packed.data());
+			}
+		}
+
+		// f(first row, const matrix<T>& panel) for every panel in order, each read while the previous one is being processed
+		template <typename F>
+		void for_each_panel(F&& f) const {
+			const std::size_t count = panel_count();
+			for (std::size_t p = 0; p != count; ++p) {
+				const panel current = m_store->load(p);
+				if (p + 1 != count) m_store->prefetch(p + 1);
+				f(m_store->first_row(p), *current);
+			}
+		}
+
+	public: /* accessors */
+		T get(std::size_t i, std::size_t j) const {
+			if (i >= shape().first || j >= shape().second) throw std::out_of_range("Out of range element access attempted for out_of_core_matrix");
+			return m_store->load(i / panel_rows())->_get(i % panel_rows(), j);
+		}
+		// the whole matrix in memory
+		matrix<T> to_matrix() const {
+			matrix<T> result(shape().first, shape().second, uninitialized);
+			for_each_panel([&result](std::size_t first, const matrix<T>& rows) {
+				std::memcpy(result.data() + first * rows.shape().second, rows.data(), rows.size() * sizeof(T));
+			});
+			return result;
+		}
+
+	public: /* streamed arithmetic */
+		// this * b with b in memory; the product is formed panel by panel straight into the in-memory result
+		template <typename B, typename = std::enable_if_t<is_matrix<B>::value || is_matrix_view<B>::value>>
+		matrix<T> mul(const B& b) const {
+			if (shape().second != b.shape().first) throw std::invalid_argument("Invalid shapes for multiplication of matrices");
+			matrix<T> result(shape().first, b.shape().second, uninitialized);
+			for_each_panel([&result, &b](std::size_t first, const matrix<T>& rows) {
+				multiply_accumulate(result.block(first, 0, rows.shape().first, result.shape().second), T(1), rows, T(0), b);
+			});
+			return result;
+		}
+		// this * b into out, which may be out of core as well; only one panel of the product is in memory at a time
+		template <typename B, typename = std::enable_if_t<is_matrix<B>::value || is_matrix_view<B>::value>>
+		void mul(const B& b, out_of_core_matrix& out) const {
+			if (shape().second != b.shape().first) throw std::invalid_argument("Invalid shapes for multiplication of matrices");
+			if (out.shape() != std::make_pair(shape().first, b.shape().second)) throw std::invalid_argument("Invalid shape for the result of a multiplication");
+			matrix<T> staging;
+			for_each_panel([&out, &b, &staging](std::size_t first, const matrix<T>& rows) {
+				mul_into(staging, rows, b);
+				out.store_rows(first, staging);
+			});
+		}
+
+		// out = f(this, b) element by element, one panel at a time; b must have this matrix's shape and panel height, out may be either operand
+		template <typename F>
+		void zip(const out_of_core_matrix& b, out_of_core_matrix& out, F&& f) const {
+			if (b.shape() != shape() || out.shape() != shape()) throw std::invalid_argument("Invalid shapes for an elementwise operation");
+			if (b.panel_rows() != panel_rows()) throw std::invalid_argument("Out-of-core operands of an elementwise operation must share their panel height");
+			matrix<T> staging;
+			for_each_panel([&b, &out, &f, &staging](std::size_t first, const matrix<T>& rows) {
+				const std::size_t p = first / b.panel_rows();
+				const panel other = b.m_store->load(p);
+				if (p + 1 != b.panel_count()) b.m_store->prefetch(p + 1);
+				if (staging.shape() != rows.shape()) staging = matrix<T>(rows.shape().first, rows.shape().second, uninitialized);
+				const T* x = rows.data();
+				const T* y = other->data();
+				T* z = staging.data();
+				sched_detail::for_ranges<T>(rows.size(), [x, y, z, &f](std::size_t lo, std::size_t hi) {
+					for (std::size_t i = lo; i != hi; ++i) z[i] = f(x[i], y[i]);
+				});
+				out.store_rows(first, staging);
+			});
+		}
+		// out = f(this) element by element, one panel at a time; out may be this matrix
+		template <typename F>
+		void transform(out_of_core_matrix& out, F&& f) const {
+			if (out.shape() != shape()) throw std::invalid_argument("Invalid shapes for an elementwise operation");
+			matrix<T> staging;
+			for_each_panel([&out, &f, &staging](std::size_t first, const matrix<T>& rows) {
+				if (staging.shape() != rows.shape()) staging = matrix<T>(rows.shape().first, rows.shape().second, uninitialized);
+				const T* x = rows.data();
+				T* z = staging.data();
+				sched_detail::for_ranges<T>(rows.size(), [x, z, &f](std::size_t lo, std::size_t hi) {
+					for (std::size_t i = lo; i != hi; ++i) z[i] = f(x[i]);
+				});
+				out.store_rows(first, staging);
+			});
+		}
+
+		void add(const out_of_core_matrix& b, out_of_core_matrix& out) const { zip(b, out, [](const T& x, const T& y) { return static_cast<T>(x + y); }); }
+		void sub(const out_of_core_matrix& b, out_of_core_matrix& out) const { zip(b, out, [](const T& x, const T& y) { return static_cast<T>(x - y); }); }
+		void mul(const T& scalar, out_of_core_matrix& out) const { transform(out, [scalar](const T& x) { return static_cast<T>(x * scalar); }); }
+
+	private:
+		explicit out_of_core_matrix(std::unique_ptr<ooc_detail::panel_store<T>> store) noexcept : m_store(std::move(store)) {}
+
+		void check_panel(std::size_t p) const {
+			if (p >= panel_count()) throw std::out_of_range("Out of range panel of an out_of_core_matrix");
+		}
+
+		std::unique_ptr<ooc_detail::panel_store<T>> m_store;
+	};
+
+}
+
+#endif // !BHAVESH_MATRIX_OUT_OF_CORE_H
@@ -0,0 +1,487 @@
+#ifndef BHAVESH_MATRIX_REDUCE_H
+#define BHAVESH_MATRIX_REDUCE_H 0.1
+
+#include "bhavesh_matrix_v1.h"
+
+#include <vector> // per-task partial results
+
+namespace bhavesh {
+
+	inline namespace detail {
+	namespace reduce_detail {
+		/*
+		 * reductions over matrices and views
+		 * a matrix or view is seen as runs: one contiguous run for a whole matrix, its rows for a row-major view, its columns for a
+		 * transposed one. runs are folded with `lanes` independent accumulators (the compiler keeps them in vector registers; see
+		 * simd_detail::make_kernel_table for the per-isa builds) which are combined by halving at the end, in leaves of `leaf` elements;
+		 * leaves are combined pairwise, so a float sum of s elements is off by O(log s) ulps rather than O(s)
+		 * axis reductions across runs (column sums of a row-major matrix) add whole rows into a row of results, also pairwise,
+		 * so the matrix is still read along its storage and never down a column
+		 */
+
+		constexpr std::size_t leaf = 1024; // elements folded in one go before results are combined pairwise
+		constexpr std::size_t rows_leaf = 32; // rows added one after another before the row results are combined pairwise
+		constexpr std::size_t slice = 1024; // results an axis reduction across runs keeps hot while rows stream past
+
+		template <typename R, typename T> R magnitude(const T& x) { const R r = static_cast<R>(x); return r < R{} ? -r : r; }
+		template <typename R, typename T> R magnitude(const std::complex<T>& x) { return static_cast<R>(std::abs(x)); }
+		template <typename R, typename T> R square(const T& x) { const R r = static_cast<R>(x); return r * r; }
+		template <typename R, typename T> R square(const std::complex<T>& x) { return static_cast<R>(std::norm(x)); }
+
+		/* an op maps each element to the accumulator type and combines two accumulated values */
+		struct sum_op {
+			template <typename R, typename T> static R map(const T& x) { return static_cast<R>(x); }
+			template <typename R> static R combine(const R& a, const R& b) { return a + b; }
+		};
+		struct prod_op {
+			template <typename R, typename T> static R map(const T& x) { return static_cast<R>(x); }
+			template <typename R> static R combine(const R& a, const R& b) { return a * b; }
+		};
+		struct min_op {
+			template <typename R, typename T> static R map(const T& x) { return static_cast<R>(x); }
+			template <typename R> static R combine(const R& a, const R& b) { return b < a ? b : a; }
+		};
+		struct max_op {
+			template <typename R, typename T> static R map(const T& x) { return static_cast<R>(x); }
+			template <typename R> static R combine(const R& a, const R& b) { return a < b ? b : a; }
+		};
+		struct abs_sum_op {
+			template <typename R, typename T> static R map(const T& x) { return magnitude<R>(x); }
+			template <typename R> static R combine(const R& a, const R& b) { return a + b; }
+		};
+		struct square_sum_op {
+			template <typename R, typename T> static R map(const T& x) { return square<R>(x); }
+			template <typename R> static R combine(const R& a, const R& b) { return a + b; }
+		};
+
+		/*
+		 * fold:      op over [p, p + s), starting every lane from init
+		 * accumulate: out[j] = op(out[j], x_r[j]) for j < s over rows x_r (ld apart), four rows per pass over out; each block of lanes
+		 *            is loaded before it is stored, so it vectorizes even though out and the rows may have the same type
+		 */
+#	define BHAVESH_REDUCE_KERNELS(isa, target) \
+		template <typename Op, typename R, typename T> \
+		target R isa##_fold(const T* p, std::size_t s, R init) { \
+			constexpr std::size_t lanes = sizeof(R) < 128 ? 128 / sizeof(R) : 1; \
+			R acc[lanes]; \
+			for (std::size_t l = 0; l != lanes; ++l) acc[l] = init; \
+			std::size_t i = 0; \
+			for (; i + lanes <= s; i += lanes) { \
+				for (std::size_t l = 0; l != lanes; ++l) acc[l] = Op::combine(acc[l], Op::template map<R>(p[i + l])); \
+			} \
+			for (std::size_t w = lanes / 2; w != 0; w /= 2) { \
+				for (std::size_t l = 0; l != w; ++l) acc[l] = Op::combine(acc[l], acc[l + w]); \
+			} \
+			R r = acc[0]; \
+			for (; i != s; ++i) r = Op::combine(r, Op::template map<R>(p[i])); \
+			return r; \
+		} \
+		template <typename Op, typename R, typename T> \
+		target void isa##_accumulate(const T* x, std::ptrdiff_t ld, std::size_t rows, std::size_t s, R* out) { \
+			constexpr std::size_t lanes = sizeof(R) < 128 ? 128 / sizeof(R) : 1; \
+			const auto four = [](const T* x0, const T* x1, const T* x2, const T* x3, std::size_t j) { \
+				return Op::combine(Op::combine(Op::template map<R>(x0[j]), Op::template map<R>(x1[j])), Op::combine(Op::template map<R>(x2[j]), Op::template map<R>(x3[j]))); \
+			}; \
+			std::size_t r = 0; \
+			for (; r + 4 <= rows; r += 4) { \
+				const T* x0 = x + static_cast<std::ptrdiff_t>(r) * ld; const T* x1 = x0 + ld; const T* x2 = x1 + ld; const T* x3 = x2 + ld; \
+				std::size_t j = 0; \
+				for (; j + lanes <= s; j += lanes) { \
+					R t[lanes]; \
+					for (std::size_t l = 0; l != lanes; ++l) t[l] = Op::combine(out[j + l], four(x0, x1, x2, x3, j + l)); \
+					for (std::size_t l = 0; l != lanes; ++l) out[j + l] = t[l]; \
+				} \
+				for (; j != s; ++j) out[j] = Op::combine(out[j], four(x0, x1, x2, x3, j)); \
+			} \
+			for (; r != rows; ++r) { \
+				const T* xr = x + static_cast<std::ptrdiff_t>(r) * ld; \
+				std::size_t j = 0; \
+				for (; j + lanes <= s; j += lanes) { \
+					R t[lanes]; \
+					for (std::size_t l = 0; l != lanes; ++l) t[l] = Op::combine(out[j + l], Op::template map<R>(xr[j + l])); \
+					for (std::size_t l = 0; l != lanes; ++l) out[j + l] = t[l]; \
+				} \
+				for (; j != s; ++j) out[j] = Op::combine(out[j], Op::template map<R>(xr[j])); \
+			} \
+		}
+
+		BHAVESH_REDUCE_KERNELS(scalar, )
+#	if BHAVESH_MATRIX_X86_SIMD
+		BHAVESH_REDUCE_KERNELS(avx2, BHAVESH_TARGET_AVX2)
+		BHAVESH_REDUCE_KERNELS(avx512, BHAVESH_TARGET_AVX512)
+#	endif
+#	undef BHAVESH_REDUCE_KERNELS
+
+		// element and accumulator types the isa-specific kernels are stamped out for; anything else (complex, user types) gets the plain ones
+		template <typename R, typename T>
+		struct has_kernels : std::integral_constant<bool,
+			std::is_arithmetic<T>::value && !std::is_same<T, bool>::value && std::is_arithmetic<R>::value && !std::is_same<R, bool>::value> {};
+
+		template <typename Op, typename R, typename T>
+		struct kernel_table {
+			R (*fold)(const T*, std::size_t, R);
+			void (*accumulate)(const T*, std::ptrdiff_t, std::size_t, std::size_t, R*);
+		};
+
+		template <typename Op, typename R, typename T>
+		inline kernel_table<Op, R, T> make_kernel_table(simd_detail::isa_t isa) {
+			switch (isa) {
+#	if BHAVESH_MATRIX_X86_SIMD
+			case simd_detail::isa_t::avx512: return { avx512_fold<Op, R, T>, avx512_accumulate<Op, R, T> };
+			case simd_detail::isa_t::avx2:   return { avx2_fold  <Op, R, T>, avx2_accumulate  <Op, R, T> };
+#	endif
+			default:                         return { scalar_fold<Op, R, T>, scalar_accumulate<Op, R, T> };
+			}
+		}
+
+		template <typename Op, typename R, typename T>
+		inline const kernel_table<Op, R, T>& kernels() {
+			static const kernel_table<Op, R, T> table = reduce_detail::make_kernel_table<Op, R, T>(simd_detail::active_isa());
+			return table;
+		}
+
+		template <typename Op, typename R, typename T>
+		inline R fold(const T* p, std::size_t s, std::ptrdiff_t inc, R init) {
+			if (inc != 1) {
+				for (std::size_t i = 0; i != s; ++i) init = Op::combine(init, Op::template map<R>(p[static_cast<std::ptrdiff_t>(i) * inc]));
+				return init;
+			}
+			if BHAVESH_CXX17_CONSTEXPR(has_kernels<R, T>::value) return kernels<Op, R, T>().fold(p, s, init);
+			else return scalar_fold<Op, R, T>(p, s, init);
+		}
+
+		template <typename Op, typename R, typename T>
+		inline void accumulate(const T* x, std::ptrdiff_t ld, std::size_t rows, std::size_t s, std::ptrdiff_t inc, R* out) {
+			if (inc != 1) {
+				for (std::size_t r = 0; r != rows; ++r) {
+					const T* xr = x + static_cast<std::ptrdiff_t>(r) * ld;
+					for (std::size_t j = 0; j != s; ++j) out[j] = Op::combine(out[j], Op::template map<R>(xr[static_cast<std::ptrdiff_t>(j) * inc]));
+				}
+				return;
+			}
+			if BHAVESH_CXX17_CONSTEXPR(has_kernels<R, T>::value) kernels<Op, R, T>().accumulate(x, ld, rows, s, out);
+			else scalar_accumulate<Op, R, T>(x, ld, rows, s, out);
+		}
+
+		// runs runs of len elements: run r starts at p + r * ld, its elements are inc apart; by_rows tells whether runs are rows or columns
+		template <typename T>
+		struct strided {
+			const T* p;
+			std::size_t runs, len;
+			std::ptrdiff_t ld, inc;
+			bool by_rows;
+			std::size_t m, n;
+
+			const T* at(std::size_t idx) const {
+				return p + static_cast<std::ptrdiff_t>(idx / len) * ld + static_cast<std::ptrdiff_t>(idx % len) * inc;
+			}
+			// (row, column) of the idx-th element in run order
+			std::pair<std::size_t, std::size_t> position(std::size_t idx) const {
+				return by_rows ? std::make_pair(idx / n, idx % n) : std::make_pair(idx % m, idx / m);
+			}
+		};
+
+		template <typename X>
+		using element_t = std::remove_cv_t<typename X::value_type>;
+
+		// runs along the storage: rows, or columns when only those are contiguous
+		template <typename X>
+		strided<element_t<X>> runs_of(const X& x) {
+			const std::size_t m = x.shape().first, n = x.shape().second;
+			const auto s = view_detail::strides(x);
+			if (s.first == 1 && s.second != 1) return { x.data(), n, m, s.second, 1, false, m, n };
+			return { x.data(), m, n, s.first, s.second, true, m, n };
+		}
+
+		// the same, merged into one run when the elements are densely packed
+		template <typename X>
+		strided<element_t<X>> flat(const X& x) {
+			auto r = runs_of(x);
+			if (r.inc == 1 && (r.runs == 1 || r.ld == static_cast<std::ptrdiff_t>(r.len))) {
+				r.len *= r.runs;
+				r.runs = 1;
+				r.ld = 0;
+			}
+			return r;
+		}
+
+		// f(pointer, count, index of the first) for pieces of at most leaf elements, none crossing a run
+		template <typename T, typename F>
+		void for_pieces(const strided<T>& x, std::size_t first, std::size_t last, F&& f) {
+			while (first != last) {
+				const std::size_t off = first % x.len;
+				const std::size_t count = std::min(std::min(last - first, x.len - off), leaf);
+				f(x.at(first), count, first);
+				first += count;
+			}
+		}
+
+		// op over elements [first, last) in run order, pairwise
+		template <typename Op, typename R, typename T>
+		R fold_range(const strided<T>& x, std::size_t first, std::size_t last, const R& init) {
+			if (last - first <= leaf) {
+				R r = init;
+				for_pieces(x, first, last, [&r, &x, &init](const T* p, std::size_t count, std::size_t) { r = Op::combine(r, fold<Op>(p, count, x.inc, init)); });
+				return r;
+			}
+			// split on whole leaves, so pieces keep the alignment of the first (unaligned wide loads would straddle cache lines)
+			const std::size_t mid = first + (last - first + leaf - 1) / leaf / 2 * leaf;
+			const R left = fold_range<Op>(x, first, mid, init); // left first: arguments may be evaluated right to left, which walks memory backwards
+			return Op::combine(left, fold_range<Op>(x, mid, last, init));
+		}
+
+		// parts[0] = op over all parts, combined as a balanced tree
+		template <typename Op, typename R>
+		R combine_tree(std::vector<R>& parts) {
+			for (std::size_t w = 1; w < parts.size(); w *= 2) {
+				for (std::size_t c = 0; c + w < parts.size(); c += 2 * w) parts[c] = Op::combine(parts[c], parts[c + w]);
+			}
+			return parts[0];
+		}
+
+		// [first, last) of chunk c of `chunks` over s elements; cuts fall on whole leaves
+		inline std::pair<std::size_t, std::size_t> chunk(std::size_t s, std::size_t c, std::size_t chunks) {
+			const auto cut = [s, chunks](std::size_t k) { return k == chunks ? s : std::min(s, s * k / chunks / leaf * leaf); };
+			return { cut(c), cut(c + 1) };
+		}
+
+		// f(first, last) -> R over a few ranges per thread when s reaches the threshold, results combined as a tree
+		template <typename Op, typename R, typename F>
+		R parallel_fold(std::size_t s, const R& init, F&& f) {
+			if (!sched_detail::worth_splitting(s)) return f(std::size_t(0), s);
+			auto& pool = sched_detail::scheduler::instance();
+			const std::size_t chunks = 4 * pool.concurrency();
+			std::vector<R> parts(chunks, init);
+			pool.parallel_for(chunks, [&parts, &f, s, chunks](std::size_t c) {
+				const auto r = chunk(s, c, chunks);
+				if (r.first != r.second) parts[c] = f(r.first, r.second);
+			});
+			return combine_tree<Op>(parts);
+		}
+
+		// op over every element of x
+		template <typename Op, typename R, typename T>
+		R reduce(const strided<T>& x, const R& init) {
+			return parallel_fold<Op>(x.runs * x.len, init, [&x, &init](std::size_t first, std::size_t last) { return fold_range<Op>(x, first, last, init); });
+		}
+
+		// for min / max: every lane starts from the first element, which is then idempotent
+		template <typename Op, typename T>
+		T reduce_extreme(const strided<T>& x, const char* what) {
+			if (x.runs * x.len == 0) throw std::invalid_argument(what);
+			return reduce<Op>(x, *x.p);
+		}
+
+		// (value, index in run order) of the first smallest or largest element in [first, last); each piece is folded with the kernels and
+		// only a piece that improves on the best so far is searched again for where its extreme is
+		template <bool largest, typename T>
+		std::pair<T, std::size_t> arg_extreme_range(const strided<T>& x, std::size_t first, std::size_t last) {
+			using Op = std::conditional_t<largest, max_op, min_op>;
+			std::pair<T, std::size_t> best(*x.at(first), first);
+			for_pieces(x, first, last, [&best, &x](const T* p, std::size_t count, std::size_t idx) {
+				const T e = fold<Op>(p, count, x.inc, *p);
+				if (largest ? best.first < e : e < best.first) {
+					std::size_t i = 0;
+					while (!(p[static_cast<std::ptrdiff_t>(i) * x.inc] == e)) ++i;
+					best = { e, idx + i };
+				}
+			});
+			return best;
+		}
+
+		template <bool largest, typename T>
+		std::pair<std::size_t, std::size_t> arg_extreme(const strided<T>& x, const char* what) {
+			const std::size_t s = x.runs * x.len;
+			if (s == 0) throw std::invalid_argument(what);
+			if (!sched_detail::worth_splitting(s)) return x.position(arg_extreme_range<largest>(x, 0, s).second);
+			auto& pool = sched_detail::scheduler::instance();
+			const std::size_t chunks = 4 * pool.concurrency();
+			std::vector<std::pair<T, std::size_t>> parts(chunks, std::make_pair(*x.p, std::size_t(0)));
+			pool.parallel_for(chunks, [&parts, &x, s, chunks](std::size_t c) {
+				const auto r = chunk(s, c, chunks);
+				if (r.first != r.second) parts[c] = arg_extreme_range<largest>(x, r.first, r.second);
+			});
+			std::pair<T, std::size_t> best = parts[0];
+			for (const auto& p : parts) { // in order, so ties keep the earliest
+				if (largest ? best.first < p.first : p.first < best.first) best = p;
+			}
+			return x.position(best.second);
+		}
+
+		// out[r] = op over run r, for every run
+		template <typename Op, typename R, typename T>
+		void fold_runs(const strided<T>& x, const R& init, R* out) {
+			const strided<T> one_run = { nullptr, 1, x.len, 0, x.inc, true, 1, x.len };
+			auto& pool = sched_detail::scheduler::instance();
+			if (x.runs >= 4 * pool.concurrency()) {
+				sched_detail::for_ranges<R>(x.runs, [&x, &init, &one_run, out](std::size_t first, std::size_t last) {
+					for (std::size_t r = first; r != last; ++r) {
+						strided<T> run = one_run;
+						run.p = x.p + static_cast<std::ptrdiff_t>(r) * x.ld;
+						out[r] = fold_range<Op>(run, 0, x.len, init);
+					}
+				}, x.len);
+				return;
+			}
+			for (std::size_t r = 0; r != x.runs; ++r) { // few long runs: split each one instead
+				strided<T> run = one_run;
+				run.p = x.p + static_cast<std::ptrdiff_t>(r) * x.ld;
+				out[r] = reduce<Op>(run, init);
+			}
+		}
+
+		// out[j] = op over runs [r0, r1) of their element j, j < w; pairwise over the runs, scratch holds w elements per level below
+		template <typename Op, typename R, typename T>
+		void fold_across(const strided<T>& x, std::size_t r0, std::size_t r1, std::size_t j0, std::size_t w, const R& init, R* out, R* scratch) {
+			if (r1 - r0 <= rows_leaf) {
+				std::fill(out, out + w, init);
+				accumulate<Op>(x.p + static_cast<std::ptrdiff_t>(r0) * x.ld + static_cast<std::ptrdiff_t>(j0) * x.inc, x.ld, r1 - r0, w, x.inc, out);
+				return;
+			}
+			const std::size_t mid = r0 + (r1 - r0) / 2;
+			fold_across<Op>(x, r0, mid, j0, w, init, out, scratch);
+			fold_across<Op>(x, mid, r1, j0, w, init, scratch, scratch + w);
+			for (std::size_t j = 0; j != w; ++j) out[j] = Op::combine(out[j], scratch[j]);
+		}
+
+		// levels of scratch fold_across needs for `runs` runs
+		inline std::size_t depth(std::size_t runs) {
+			std::size_t levels = 1;
+			for (; runs > rows_leaf; runs = (runs + 1) / 2) ++levels;
+			return levels;
+		}
+
+		// out[j] = op over all runs of their element j, j < len
+		// wide results are cut into slices, one pool task each; narrow ones (where slices would be too thin) get per-task partial results over run ranges
+		template <typename Op, typename R, typename T>
+		void fold_across_runs(const strided<T>& x, const R& init, R* out) {
+			const auto columns = [&x, &init](std::size_t r0, std::size_t r1, std::size_t j0, std::size_t j1, R* dst) {
+				std::vector<R> scratch(depth(r1 - r0) * std::min(slice, j1 - j0));
+				for (std::size_t j = j0; j < j1; j += slice) fold_across<Op>(x, r0, r1, j, std::min(slice, j1 - j), init, dst + (j - j0), scratch.data());
+			};
+			if (x.runs == 0) {
+				std::fill(out, out + x.len, init);
+				return;
+			}
+			auto& pool = sched_detail::scheduler::instance();
+			if (!sched_detail::worth_splitting(x.runs * x.len)) {
+				columns(0, x.runs, 0, x.len, out);
+				return;
+			}
+			const std::size_t parts = pool.concurrency();
+			if (x.len >= parts * (4096 / sizeof(R))) { // at least 4 KiB of results per thread
+				sched_detail::for_ranges<R>(x.len, [&columns, &x, out](std::size_t first, std::size_t last) { columns(0, x.runs, first, last, out + first); }, x.runs);
+				return;
+			}
+			const std::size_t chunks = std::min(x.runs, parts);
+			std::vector<R> partial(chunks * x.len, init);
+			pool.parallel_for(chunks, [&columns, &partial, &x, chunks](std::size_t c) {
+				columns(x.runs * c / chunks, x.runs * (c + 1) / chunks, 0, x.len, partial.data() + c * x.len);
+			});
+			for (std::size_t w = 1; w < chunks; w *= 2) {
+				for (std::size_t c = 0; c + w < chunks; c += 2 * w) {
+					R* a = partial.data() + c * x.len;
+					const R* b = partial.data() + (c + w) * x.len;
+					for (std::size_t j = 0; j != x.len; ++j) a[j] = Op::combine(a[j], b[j]);
+				}
+			}
+			std::copy(partial.data(), partial.data() + x.len, out);
+		}
+
+		// out[i] = op over row i (rows == true) or column i of x
+		template <typename Op, typename R, typename X>
+		void fold_axis(const X& x, bool rows, const R& init, R* out) {
+			const auto r = runs_of(x);
+			if (r.by_rows == rows) fold_runs<Op>(r, init, out);
+			else fold_across_runs<Op>(r, init, out);
+		}
+
+		template <typename X>
+		using enable_if_reducible = std::enable_if_t<is_matrix<X>::value || is_matrix_view<X>::value>;
+
+		// what norms are computed in: double for integers, the real type of complex numbers
+		template <typename T>
+		using norm_t = linalg_detail::real_t<linalg_detail::field_t<T>>;
+	}
+	}
+
+	/*
+	 * reductions of a matrix or view (a dense_vector reduces through as_column()); large inputs are split over matrix_scheduler's pool
+	 * and the partial results combined as a tree. sums and norms accumulate pairwise, so the rounding error of a float sum grows with
+	 * log(size) rather than size; min / max and their positions leave unordered (NaN) elements with an unspecified result
+	 */
+
+	template <typename X, typename = reduce_detail::enable_if_reducible<X>>
+	reduce_detail::element_t<X> sum(const X& x) {
+		using T = reduce_detail::element_t<X>;
+		return reduce_detail::reduce<reduce_detail::sum_op>(reduce_detail::flat(x), T{});
+	}
+
+	template <typename X, typename = reduce_detail::enable_if_reducible<X>>
+	reduce_detail::element_t<X> prod(const X& x) {
+		using T = reduce_detail::element_t<X>;
+		return reduce_detail::reduce<reduce_detail::prod_op>(reduce_detail::flat(x), T(1));
+	}
+
+	// throws std::invalid_argument for an empty matrix; the names are parenthesized against the min / max macros of <windows.h>
+	template <typename X, typename = reduce_detail::enable_if_reducible<X>>
+	reduce_detail::element_t<X> (min)(const X& x) {
+		return reduce_detail::reduce_extreme<reduce_detail::min_op>(reduce_detail::flat(x), "Minimum of an empty matrix");
+	}
+
+	template <typename X, typename = reduce_detail::enable_if_reducible<X>>
+	reduce_detail::element_t<X> (max)(const X& x) {
+		return reduce_detail::reduce_extreme<reduce_detail::max_op>(reduce_detail::flat(x), "Maximum of an empty matrix");
+	}
+
+	// (row, column) of a smallest / largest element; among equal ones the first in storage order
+	template <typename X, typename = reduce_detail::enable_if_reducible<X>>
+	std::pair<std::size_t, std::size_t> argmin(const X& x) {
+		return reduce_detail::arg_extreme<false>(reduce_detail::flat(x), "Minimum of an empty matrix");
+	}
+
+	template <typename X, typename = reduce_detail::enable_if_reducible<X>>
+	std::pair<std::size_t, std::size_t> argmax(const X& x) {
+		return reduce_detail::arg_extreme<true>(reduce_detail::flat(x), "Maximum of an empty matrix");
+	}
+
+	// sums of each row (m values) and of each column (n values)
+	template <typename X, typename T = reduce_detail::element_t<X>, typename = reduce_detail::enable_if_reducible<X>>
+	dense_vector<T> row_sums(const X& x) {
+		dense_vector<T> out(x.shape().first, uninitialized);
+		reduce_detail::fold_axis<reduce_detail::sum_op>(x, true, T{}, out.data());
+		return out;
+	}
+
+	template <typename X, typename T = reduce_detail::element_t<X>, typename = reduce_detail::enable_if_reducible<X>>
+	dense_vector<T> col_sums(const X& x) {
+		dense_vector<T> out(x.shape().second, uninitialized);
+		reduce_detail::fold_axis<reduce_detail::sum_op>(x, false, T{}, out.data());
+		return out;
+	}
+
+	enum class matrix_norm : std::uint8_t {
+		frobenius, // sqrt of the sum of |a_ij|^2
+		one,       // largest column sum of |a_ij|
+		infinity,  // largest row sum of |a_ij|
+	};
+
+	// integer matrices are measured in double, complex ones in their real type; an empty matrix has norm 0
+	template <typename X, typename = reduce_detail::enable_if_reducible<X>>
+	reduce_detail::norm_t<reduce_detail::element_t<X>> norm(const X& x, matrix_norm kind = matrix_norm::frobenius) {
+		using R = reduce_detail::norm_t<reduce_detail::element_t<X>>;
+		if (kind == matrix_norm::frobenius) {
+			using std::sqrt;
+			return sqrt(reduce_detail::reduce<reduce_detail::square_sum_op>(reduce_detail::flat(x), R{}));
+		}
+		const bool rows = kind == matrix_norm::infinity;
+		const std::size_t s = rows ? x.shape().first : x.shape().second;
+		if (s == 0 || x.shape().first * x.shape().second == 0) return R{};
+		std::vector<R> sums(s);
+		reduce_detail::fold_axis<reduce_detail::abs_sum_op>(x, rows, R{}, sums.data());
+		return reduce_detail::fold<reduce_detail::max_op>(sums.data(), s, 1, sums[0]);
+	}
+
+}
+
+#endif // !BHAVESH_MATRIX_REDUCE_H
@@ -0,0 +1,411 @@
+#ifndef BHAVESH_MATRIX_SPARSE_H
+#define BHAVESH_MATRIX_SPARSE_H 0.1
+
+#include "bhavesh_matrix_v1.h"
+
+#include <vector> // compressed storage
+
+namespace bhavesh {
+
+	// csr keeps each row's stored values together, csc each column's
+	enum class sparse_format { csr, csc };
+
+	// one stored value given by its coordinates (coo); duplicates are summed when a sparse_matrix is built from entries
+	template <typename T>
+	struct sparse_entry {
+		std::size_t row;
+		std::size_t col;
+		T value;
+	};
+
+	template <typename T, sparse_format F = sparse_format::csr> class sparse_matrix;
+	template <typename T> using csr_matrix = sparse_matrix<T, sparse_format::csr>;
+	template <typename T> using csc_matrix = sparse_matrix<T, sparse_format::csc>;
+
+	template <typename T, sparse_format F> struct is_sparse_matrix<sparse_matrix<T, F>> : std::true_type {};
+
+	inline namespace detail {
+	namespace sparse_detail {
+		/*
+		 * the compressed dimension is the outer one (rows for csr, columns for csc): offsets[o] .. offsets[o + 1] are the positions of
+		 * outer index o's values in indices (their inner index, ascending) and values
+		 * work is split by cutting the outer extent where the running count of stored values plus outer indices crosses even shares,
+		 * so a few dense rows do not land on one thread
+		 */
+		inline std::size_t outer_cut(const std::vector<std::size_t>& offsets, std::size_t chunks, std::size_t c) noexcept {
+			const std::size_t outer = offsets.size() - 1;
+			if (c >= chunks) return outer;
+			const std::size_t target = (offsets.back() + outer) / chunks * c;
+			std::size_t lo = 0, hi = outer;
+			while (lo < hi) { // first o with offsets[o] + o >= target; offsets[o] + o is strictly increasing
+				const std::size_t mid = lo + (hi - lo) / 2;
+				if (offsets[mid] + mid < target) lo = mid + 1;
+				else hi = mid;
+			}
+			return lo;
+		}
+
+		// f(first, last) over [0, outer) in ranges of even work; cost is the work per stored value, in elements
+		template <typename F>
+		void for_outer(const std::vector<std::size_t>& offsets, std::size_t cost, F&& f) {
+			const std::size_t outer = offsets.size() - 1;
+			if (outer < 2 || !sched_detail::worth_splitting((offsets.back() + outer) * cost)) {
+				f(std::size_t(0), outer);
+				return;
+			}
+			const std::size_t chunks = std::min(outer, 4 * sched_detail::scheduler::instance().concurrency());
+			sched_detail::scheduler::instance().parallel_for(chunks, [&offsets, &f, chunks](std::size_t c) {
+				const std::size_t first = outer_cut(offsets, chunks, c), last = outer_cut(offsets, chunks, c + 1);
+				if (first != last) f(first, last);
+			});
+		}
+
+		// y = A x for csr: one dot product per row
+		template <typename T>
+		void csr_gemv(const std::vector<std::size_t>& offsets, const std::size_t* idx, const T* val, const T* x, std::ptrdiff_t incx, T* y, std::ptrdiff_t incy) {
+			for_outer(offsets, 1, [&offsets, idx, val, x, incx, y, incy](std::size_t first, std::size_t last) {
+				for (std::size_t i = first; i != last; ++i) {
+					T sum{};
+					for (std::size_t p = offsets[i]; p != offsets[i + 1]; ++p) sum += val[p] * x[static_cast<std::ptrdiff_t>(idx[p]) * incx];
+					y[static_cast<std::ptrdiff_t>(i) * incy] = sum;
+				}
+			});
+		}
+
+		// y = A x for csc: every column scatters into y, so threads scatter into private copies of y that are summed afterwards
+		template <typename T>
+		void csc_gemv(std::size_t m, const std::vector<std::size_t>& offsets, const std::size_t* idx, const T* val, const T* x, std::ptrdiff_t incx, T* y, std::ptrdiff_t incy) {
+			const std::size_t n = offsets.size() - 1;
+			const auto scatter = [&offsets, idx, val, x, incx](T* out, std::size_t first, std::size_t last) {
+				for (std::size_t j = first; j != last; ++j) {
+					const T xj = x[static_cast<std::ptrdiff_t>(j) * incx];
+					for (std::size_t p = offsets[j]; p != offsets[j + 1]; ++p) out[idx[p]] += val[p] * xj;
+				}
+			};
+			const std::size_t chunks = n < 2 || !sched_detail::worth_splitting(offsets.back() + n + m) ? 1 : std::min(n, sched_detail::scheduler::instance().concurrency());
+			std::vector<T> partial(chunks * m, T{});
+			sched_detail::scheduler::instance().parallel_for(chunks, [&](std::size_t c) {
+				scatter(partial.data() + c * m, outer_cut(offsets, chunks, c), outer_cut(offsets, chunks, c + 1));
+			});
+			sched_detail::for_ranges<T>(m, [&partial, m, chunks, y, incy](std::size_t first, std::size_t last) {
+				for (std::size_t i = first; i != last; ++i) {
+					T sum = partial[i];
+					for (std::size_t c = 1; c != chunks; ++c) sum += partial[c * m + i];
+					y[static_cast<std::ptrdiff_t>(i) * incy] = sum;
+				}
+			}, chunks);
+		}
+
+		// c_row[0, n) += a * b_row[0, n) with b_row's elements cb apart
+		template <typename T>
+		inline void axpy(std::size_t n, const T& a, const T* b_row, std::ptrdiff_t cb, T* c_row) {
+			if (cb == 1) for (std::size_t j = 0; j != n; ++j) c_row[j] += a * b_row[j];
+			else for (std::size_t j = 0; j != n; ++j) c_row[j] += a * b_row[static_cast<std::ptrdiff_t>(j) * cb];
+		}
+
+		// C (m x n, row-major, contiguous) = A * B, A sparse m x k, B dense k x n given by strides
+		template <typename T, sparse_format F>
+		void spmm(const sparse_matrix<T, F>& a, const T* b, std::ptrdiff_t rb, std::ptrdiff_t cb, std::size_t n, T* c) {
+			const std::size_t m = a.shape().first;
+			const std::vector<std::size_t>& offsets = a.offsets();
+			const std::size_t* idx = a.indices().data();
+			const T* val = a.values().data();
+			if (n == 1) {
+				if BHAVESH_CXX17_CONSTEXPR (F == sparse_format::csr) csr_gemv(offsets, idx, val, b, rb, c, 1);
+				else csc_gemv(m, offsets, idx, val, b, rb, c, 1);
+			}
+			else if BHAVESH_CXX17_CONSTEXPR (F == sparse_format::csr) { // row i of C gathers the rows of B its stored values point at
+				for_outer(offsets, n, [&offsets, idx, val, b, rb, cb, n, c](std::size_t first, std::size_t last) {
+					for (std::size_t i = first; i != last; ++i) {
+						T* c_row = c + i * n;
+						std::fill(c_row, c_row + n, T{});
+						for (std::size_t p = offsets[i]; p != offsets[i + 1]; ++p) axpy(n, val[p], b + static_cast<std::ptrdiff_t>(idx[p]) * rb, cb, c_row);
+					}
+				});
+			}
+			else { // column p of A scatters row p of B into C; threads own disjoint column ranges of C
+				std::fill(c, c + m * n, T{});
+				sched_detail::for_ranges<T>(n, [&offsets, idx, val, b, rb, cb, n, c](std::size_t first, std::size_t last) {
+					for (std::size_t p = 0; p + 1 < offsets.size(); ++p) {
+						const T* b_row = b + static_cast<std::ptrdiff_t>(p) * rb + static_cast<std::ptrdiff_t>(first) * cb;
+						for (std::size_t q = offsets[p]; q != offsets[p + 1]; ++q) axpy(last - first, val[q], b_row, cb, c + idx[q] * n + first);
+					}
+				}, offsets.back() + offsets.size());
+			}
+		}
+
+		// C (m x n, row-major, contiguous) = B * A, B dense m x k given by strides, A sparse k x n
+		template <typename T, sparse_format F>
+		void dense_spmm(const T* b, std::ptrdiff_t rb, std::ptrdiff_t cb, std::size_t m, const sparse_matrix<T, F>& a, T* c) {
+			const std::size_t k = a.shape().first, n = a.shape().second;
+			const std::vector<std::size_t>& offsets = a.offsets();
+			const std::size_t* idx = a.indices().data();
+			const T* val = a.values().data();
+			sched_detail::for_ranges<T>(m, [&offsets, idx, val, b, rb, cb, k, n, c](std::size_t first, std::size_t last) {
+				for (std::size_t i = first; i != last; ++i) {
+					const T* b_row = b + static_cast<std::ptrdiff_t>(i) * rb;
+					T* c_row = c + i * n;
+					if BHAVESH_CXX17_CONSTEXPR (F == sparse_format::csr) { // row i of C accumulates the rows of A weighted by row i of B
+						std::fill(c_row, c_row + n, T{});
+						for (std::size_t p = 0; p != k; ++p) {
+							const T bp = b_row[static_cast<std::ptrdiff_t>(p) * cb];
+							if (bp == T{}) continue;
+							for (std::size_t q = offsets[p]; q != offsets[p + 1]; ++q) c_row[idx[q]] += bp * val[q];
+						}
+					}
+					else { // C[i][j] is row i of B dotted with the stored values of column j
+						for (std::size_t j = 0; j != n; ++j) {
+							T sum{};
+							for (std::size_t q = offsets[j]; q != offsets[j + 1]; ++q) sum += b_row[static_cast<std::ptrdiff_t>(idx[q]) * cb] * val[q];
+							c_row[j] = sum;
+						}
+					}
+				}
+			}, a.nonzeros() + k + 1);
+		}
+	}
+	}
+
+	/*
+	 * compressed sparse row (csr_matrix) or column (csc_matrix) storage: only the stored values, their inner indices, and one offset per
+	 * row (column) are kept, so memory and the products below are proportional to the number of stored values rather than to rows * cols
+	 * built from a dense matrix or view (exact zeros are dropped) or from coo entries; products with dense operands give dense matrices
+	 * (sparse * matrix, matrix * sparse, sparse * std::vector) and are split over matrix_scheduler's pool by stored values
+	 */
+	template <typename T, sparse_format F>
+	class sparse_matrix {
+		static constexpr bool row_major = F == sparse_format::csr;
+
+	public:
+		using value_type = T;
+		static constexpr sparse_format format = F;
+
+		sparse_matrix() : m_offsets(1, 0) {}
+		// an empty (all zero) rows x cols matrix
+		sparse_matrix(std::size_t rows, std::size_t cols) : m(rows), n(cols), m_offsets(outer() + 1, 0) {}
+
+		// the nonzero elements of a dense matrix or view
+		template <typename X, typename = std::enable_if_t<is_matrix<X>::value || is_matrix_view<X>::value>>
+		explicit sparse_matrix(const X& dense) : m(dense.shape().first), n(dense.shape().second), m_offsets(outer() + 1, 0) {
+			const auto s = view_detail::strides(dense);
+			const std::ptrdiff_t so = row_major ? s.first : s.second, si = row_major ? s.second : s.first;
+			const auto* data = dense.data();
+			const std::size_t inner_extent = inner();
+
+			sched_detail::for_ranges<std::size_t>(outer(), [this, data, so, si, inner_extent](std::size_t first, std::size_t last) {
+				for (std::size_t o = first; o != last; ++o) {
+					std::size_t count = 0;
+					for (std::size_t i = 0; i != inner_extent; ++i) count += data[static_cast<std::ptrdiff_t>(o) * so + static_cast<std::ptrdiff_t>(i) * si] != T{};
+					m_offsets[o + 1] = count;
+				}
+			}, inner_extent);
+			for (std::size_t o = 0; o != outer(); ++o) m_offsets[o + 1] += m_offsets[o];
+
+			m_indices.resize(m_offsets.back());
+			m_values.resize(m_offsets.back());
+			sparse_detail::for_outer(m_offsets, 1, [this, data, so, si, inner_extent](std::size_t first, std::size_t last) {
+				for (std::size_t o = first; o != last; ++o) {
+					std::size_t p = m_offsets[o];
+					for (std::size_t i = 0; i != inner_extent; ++i) {
+						const T& v = data[static_cast<std::ptrdiff_t>(o) * so + static_cast<std::ptrdiff_t>(i) * si];
+						if (v == T{}) continue;
+						m_indices[p] = i;
+						m_values[p++] = v;
+					}
+				}
+			});
+		}
+
+		// coo entries (anything iterable whose elements have row, col and value members, such as sparse_entry<T>); duplicates are summed
+		template <typename R, typename = std::enable_if_t<!std::is_integral<R>::value>>
+		sparse_matrix(std::size_t rows, std::size_t cols, const R& entries) : m(rows), n(cols), m_offsets(outer() + 1, 0) {
+			for (const auto& e : entries) {
+				if (e.row >= m || e.col >= n) throw std::out_of_range("Entry outside the shape of a sparse_matrix");
+				++m_offsets[(row_major ? e.row : e.col) + 1];
+			}
+			for (std::size_t o = 0; o != outer(); ++o) m_offsets[o + 1] += m_offsets[o];
+
+			std::vector<std::pair<std::size_t, T>> placed(m_offsets.back()); // (inner, value), bucketed by outer index
+			{
+				std::vector<std::size_t> next(m_offsets.begin(), m_offsets.end() - 1);
+				for (const auto& e : entries) placed[next[row_major ? e.row : e.col]++] = { row_major ? e.col : e.row, static_cast<T>(e.value) };
+			}
+
+			std::vector<std::size_t> kept(outer() + 1, 0); // entries left per outer index once duplicates are merged
+			sparse_detail::for_outer(m_offsets, 8, [this, &placed, &kept](std::size_t first, std::size_t last) {
+				for (std::size_t o = first; o != last; ++o) {
+					const auto begin = placed.begin() + static_cast<std::ptrdiff_t>(m_offsets[o]), end = placed.begin() + static_cast<std::ptrdiff_t>(m_offsets[o + 1]);
+					std::stable_sort(begin, end, [](const std::pair<std::size_t, T>& x, const std::pair<std::size_t, T>& y) { return x.first < y.first; });
+					auto out = begin;
+					for (auto it = begin; it != end; ++it) {
+						if (out != begin && std::prev(out)->first == it->first) std::prev(out)->second += it->second;
+						else *out++ = *it;
+					}
+					kept[o + 1] = static_cast<std::size_t>(out - begin);
+				}
+			});
+			for (std::size_t o = 0; o != outer(); ++o) kept[o + 1] += kept[o];
+
+			m_indices.resize(kept.back());
+			m_values.resize(kept.back());
+			sparse_detail::for_outer(kept, 1, [this, &placed, &kept](std::size_t first, std::size_t last) {
+				for (std::size_t o = first; o != last; ++o) {
+					for (std::size_t p = kept[o], q = m_offsets[o]; p != kept[o + 1]; ++p, ++q) {
+						m_indices[p] = placed[q].first;
+						m_values[p] = placed[q].second;
+					}
+				}
+			});
+			m_offsets = std::move(kept);
+		}
+
+		// adopts ready-made compressed arrays (see offsets() for their meaning); only their sizes and the index bounds are checked
+		sparse_matrix(std::size_t rows, std::size_t cols, std::vector<std::size_t> offsets, std::vector<std::size_t> indices, std::vector<T> values)
+			: m(rows), n(cols), m_offsets(std::move(offsets)), m_indices(std::move(indices)), m_values(std::move(values)) {
+			if (m_offsets.size() != outer() + 1 || m_offsets.front() != 0 || m_offsets.back() != m_indices.size() || m_indices.size() != m_values.size()) {
+				throw std::invalid_argument("Inconsistent compressed arrays for a sparse_matrix");
+			}
+			for (std::size_t o = 0; o != outer(); ++o) if (m_offsets[o] > m_offsets[o + 1]) throw std::invalid_argument("Inconsistent compressed arrays for a sparse_matrix");
+			for (const std::size_t i : m_indices) if (i >= inner()) throw std::out_of_range("Index outside the shape of a sparse_matrix");
+		}
+
+		// the same matrix in the other format
+		template <sparse_format G, typename = std::enable_if_t<G != F>>
+		explicit sparse_matrix(const sparse_matrix<T, G>& oth) : sparse_matrix(oth.transposed_layout()) {}
+
+	public: /* shape information */
+		std::pair<std::size_t, std::size_t> shape() const noexcept { return { m, n }; }
+		std::size_t nonzeros() const noexcept { return m_values.size(); }
+
+	public: /* storage */
+		// offsets()[o] .. offsets()[o + 1] are the positions in indices() / values() of row o (csr) or column o (csc)
+		const std::vector<std::size_t>& offsets() const noexcept { return m_offsets; }
+		// column (csr) or row (csc) of each stored value, ascending within a row (column)
+		const std::vector<std::size_t>& indices() const noexcept { return m_indices; }
+		const std::vector<T>& values() const noexcept { return m_values; }
+
+	public: /* accessors */
+		T get(std::size_t i, std::size_t j) const {
+			if (i >= m || j >= n) throw std::out_of_range("Out of range element access attempted for sparse_matrix");
+			const std::size_t o = row_major ? i : j, in = row_major ? j : i;
+			const auto begin = m_indices.begin() + static_cast<std::ptrdiff_t>(m_offsets[o]), end = m_indices.begin() + static_cast<std::ptrdiff_t>(m_offsets[o + 1]);
+			const auto it = std::lower_bound(begin, end, in);
+			return it != end && *it == in ? m_values[static_cast<std::size_t>(it - m_indices.begin())] : T{};
+		}
+
+		template <typename Alloc = BHAVESH_MATRIX_DEFAULT_ALLOCATOR>
+		matrix<T, Alloc> to_matrix() const {
+			matrix<T, Alloc> result(m, n, uninitialized);
+			T* const data = result.data();
+			std::fill(data, data + m * n, T{});
+			const std::size_t ro = row_major ? n : 1, ri = row_major ? 1 : n;
+			sparse_detail::for_outer(m_offsets, 1, [this, data, ro, ri](std::size_t first, std::size_t last) {
+				for (std::size_t o = first; o != last; ++o) {
+					for (std::size_t p = m_offsets[o]; p != m_offsets[o + 1]; ++p) data[o * ro + m_indices[p] * ri] = m_values[p];
+				}
+			});
+			return result;
+		}
+
+		// the transpose, in the other format: the compressed arrays are reused as they are
+		sparse_matrix<T, row_major ? sparse_format::csc : sparse_format::csr> transposed() const {
+			return sparse_matrix<T, row_major ? sparse_format::csc : sparse_format::csr>(n, m, m_offsets, m_indices, m_values);
+		}
+
+	public: /* products with dense operands */
+		// this * b, b a matrix or view with this->shape().second rows
+		template <typename B, typename = std::enable_if_t<(is_matrix<B>::value || is_matrix_view<B>::value) && std::is_same<std::remove_cv_t<typename B::value_type>, T>::value>>
+		matrix<T> mul(const B& b) const {
+			if (n != b.shape().first) throw std::invalid_argument("Invalid shapes for multiplication of matrices");
+			matrix<T> result(m, b.shape().second, uninitialized);
+			const auto s = view_detail::strides(b);
+			if (result.size()) sparse_detail::spmm(*this, b.data(), s.first, s.second, b.shape().second, result.data());
+			return result;
+		}
+		// this * x
+		std::vector<T> mul(const std::vector<T>& x) const {
+			if (n != x.size()) throw std::invalid_argument("Invalid shapes for multiplication of a sparse_matrix and a vector");
+			std::vector<T> y(m);
+			if BHAVESH_CXX17_CONSTEXPR (row_major) sparse_detail::csr_gemv(m_offsets, m_indices.data(), m_values.data(), x.data(), 1, y.data(), 1);
+			else sparse_detail::csc_gemv(m, m_offsets, m_indices.data(), m_values.data(), x.data(), 1, y.data(), 1);
+			return y;
+		}
+		// b * this, b a matrix or view with this->shape().first columns
+		template <typename B, typename = std::enable_if_t<(is_matrix<B>::value || is_matrix_view<B>::value) && std::is_same<std::remove_cv_t<typename B::value_type>, T>::value>>
+		matrix<T> rmul(const B& b) const {
+			if (b.shape().second != m) throw std::invalid_argument("Invalid shapes for multiplication of matrices");
+			matrix<T> result(b.shape().first, n, uninitialized);
+			const auto s = view_detail::strides(b);
+			if (result.size()) sparse_detail::dense_spmm(b.data(), s.first, s.second, b.shape().first, *this, result.data());
+			return result;
+		}
+
+	public: /* scalar arithmetic */
+		sparse_matrix mul(const T& scalar) const {
+			sparse_matrix result(*this);
+			result.mul_eq(scalar);
+			return result;
+		}
+		sparse_matrix& mul_eq(const T& scalar) {
+			T* const val = m_values.data();
+			sched_detail::for_ranges<T>(m_values.size(), [val, &scalar](std::size_t first, std::size_t last) {
+				for (std::size_t p = first; p != last; ++p) val[p] *= scalar;
+			});
+			return *this;
+		}
+		sparse_matrix& operator*=(const T& scalar) { return mul_eq(scalar); }
+
+	public: /* comparisons */
+		// same shape and the same stored values at the same places (explicitly stored zeros count as stored)
+		bool operator==(const sparse_matrix& oth) const { return m == oth.m && n == oth.n && m_offsets == oth.m_offsets && m_indices == oth.m_indices && m_values == oth.m_values; }
+		bool operator!=(const sparse_matrix& oth) const { return !(*this == oth); }
+
+	private:
+		template <typename, sparse_format> friend class sparse_matrix;
+
+		std::size_t outer() const noexcept { return row_major ? m : n; }
+		std::size_t inner() const noexcept { return row_major ? n : m; }
+
+		// this matrix's elements compressed along the other dimension: a counting sort of the stored values by inner index
+		sparse_matrix<T, row_major ? sparse_format::csc : sparse_format::csr> transposed_layout() const {
+			std::vector<std::size_t> offsets(inner() + 1, 0);
+			for (const std::size_t i : m_indices) ++offsets[i + 1];
+			for (std::size_t i = 0; i != inner(); ++i) offsets[i + 1] += offsets[i];
+			std::vector<std::size_t> indices(nonzeros());
+			std::vector<T> values(nonzeros());
+			std::vector<std::size_t> next(offsets.begin(), offsets.end() - 1);
+			for (std::size_t o = 0; o != outer(); ++o) { // ascending o keeps the new inner indices sorted
+				for (std::size_t p = m_offsets[o]; p != m_offsets[o + 1]; ++p) {
+					const std::size_t q = next[m_indices[p]]++;
+					indices[q] = o;
+					values[q] = m_values[p];
+				}
+			}
+			return sparse_matrix<T, row_major ? sparse_format::csc : sparse_format::csr>(m, n, std::move(offsets), std::move(indices), std::move(values));
+		}
+
+		std::size_t m = 0;
+		std::size_t n = 0;
+		std::vector<std::size_t> m_offsets;
+		std::vector<std::size_t> m_indices;
+		std::vector<T> m_values;
+	};
+
+	template <typename T, sparse_format F, typename B, typename = std::enable_if_t<is_matrix<B>::value || is_matrix_view<B>::value>>
+	matrix<T> operator*(const sparse_matrix<T, F>& a, const B& b) { return a.mul(b); }
+
+	template <typename A, typename T, sparse_format F, typename = std::enable_if_t<is_matrix<A>::value || is_matrix_view<A>::value>>
+	matrix<T> operator*(const A& a, const sparse_matrix<T, F>& b) { return b.rmul(a); }
+
+	template <typename T, sparse_format F>
+	std::vector<T> operator*(const sparse_matrix<T, F>& a, const std::vector<T>& x) { return a.mul(x); }
+
+	template <typename T, sparse_format F>
+	sparse_matrix<T, F> operator*(const sparse_matrix<T, F>& a, const T& scalar) { return a.mul(scalar); }
+
+	template <typename T, sparse_format F>
+	sparse_matrix<T, F> operator*(const T& scalar, const sparse_matrix<T, F>& a) { return a.mul(scalar); }
+
+}
+
+#endif // !BHAVESH_MATRIX_SPARSE_H
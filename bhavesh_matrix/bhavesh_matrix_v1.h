@@ -61,9 +61,40 @@
 #include <complex> // complex numbers of fields are fields
 #include <type_traits> // commonly used; enable_if...
 #include <algorithm> // for_each
+#include <cstdint> // fixed width integers for the simd kernels
+#include <mutex> // pooled allocator
+#include <functional> // std::less for pointer comparisons
+#include <cmath> // std::pow for the strassen error bound
+#include <limits> // numeric_limits
+#include <vector> // scheduler threads and deques
+#include <deque> // work-stealing deques
+#include <thread> // scheduler workers
+#include <atomic> // scheduler bookkeeping
+#include <condition_variable> // idle workers
+#include <exception> // exceptions thrown inside parallel tasks
+#if BHAVESH_MATRIX_PIN_THREADS
+# if defined(_WIN32)
+#   ifndef NOMINMAX
+#     define NOMINMAX
+#   endif
+#   include <windows.h> // SetThreadAffinityMask
+# elif defined(__linux__)
+#   include <pthread.h> // pthread_setaffinity_np
+#   include <sched.h> // cpu_set_t
+# endif
+#endif
 #if BHAVESH_CXX17
 #include <execution> // execution_policy
 #endif
+#if (defined(__x86_64__) || defined(_M_X64)) && !defined(BHAVESH_MATRIX_NO_SIMD)
+# define BHAVESH_MATRIX_X86_SIMD true
+# include <immintrin.h> // sse2 / avx2 / avx512 intrinsics
+# ifdef _MSC_VER
+#   include <intrin.h> // __cpuidex
+# endif
+#else
+# define BHAVESH_MATRIX_X86_SIMD false
+#endif
 #if BHAVESH_CXX20
 #include <concepts> // used with ranges
 #include <ranges>   // view_base
@@ -113,17 +144,578 @@ namespace bhavesh {
 #endif // !BHAVESH_SILENCE_T
 
 	inline namespace detail {
-	namespace matrix_detail {
+	namespace pool_detail {
+		/*
+		 * backing store for matrix_aligned_pool_allocator
+		 * requests are rounded up to power-of-two size classes (64B .. 256KiB), each block is 64 byte aligned
+		 * every thread keeps a small free list per class; overflowing/underflowing lists trade half their blocks with a mutex protected global list
+		 * anything above the largest class goes straight to aligned operator new
+		 */
+
+		constexpr std::size_t alignment = 64;
+		constexpr std::size_t min_class_shift = 6;  // 64 bytes
+		constexpr std::size_t max_class_shift = 18; // 256 KiB
+		constexpr std::size_t class_count = max_class_shift - min_class_shift + 1;
+
+		// per thread per class: at most 256 blocks or 1 MiB, whichever is fewer (but always a few)
+		constexpr std::size_t thread_cache_limit(std::size_t cls) {
+			return std::max<std::size_t>(4, std::min<std::size_t>(256, (std::size_t(1) << 20) >> (cls + min_class_shift)));
+		}
 
-		// wrappers for easier access + more readability
+		inline std::size_t size_class(std::size_t bytes) {
+			std::size_t cls = 0;
+			while ((std::size_t(1) << (cls + min_class_shift)) < bytes) ++cls;
+			return cls;
+		}
+
+		struct free_block { free_block* next; };
+
+		struct global_pool {
+			std::mutex lock[class_count];
+			free_block* head[class_count] = {};
+			std::size_t count[class_count] = {};
+		};
+
+		// intentionally leaked so that threads outliving static destruction can still hand their blocks back
+		inline global_pool& global() {
+			static global_pool* pool = new global_pool();
+			return *pool;
+		}
+
+		inline void* fresh_block(std::size_t cls) {
+			return ::operator new(std::size_t(1) << (cls + min_class_shift), std::align_val_t{ alignment });
+		}
+
+		inline void release_block(void* p, std::size_t cls) {
+			::operator delete(p, std::size_t(1) << (cls + min_class_shift), std::align_val_t{ alignment });
+		}
+
+		struct thread_cache {
+			free_block* head[class_count] = {};
+			std::size_t count[class_count] = {};
+
+			thread_cache() = default;
+			thread_cache(const thread_cache&) = delete;
+			thread_cache& operator=(const thread_cache&) = delete;
+			~thread_cache() {
+				for (std::size_t cls = 0; cls != class_count; ++cls) give_back(cls, count[cls]);
+			}
+
+			void* pop(std::size_t cls) {
+				if (!head[cls]) refill(cls);
+				if (!head[cls]) return fresh_block(cls);
+				free_block* b = head[cls];
+				head[cls] = b->next;
+				--count[cls];
+				return b;
+			}
+
+			void push(void* p, std::size_t cls) {
+				free_block* b = static_cast<free_block*>(p);
+				b->next = head[cls];
+				head[cls] = b;
+				if (++count[cls] > thread_cache_limit(cls)) give_back(cls, count[cls] / 2);
+			}
+
+		private:
+			void refill(std::size_t cls) {
+				global_pool& g = global();
+				std::lock_guard<std::mutex> guard(g.lock[cls]);
+				const std::size_t want = thread_cache_limit(cls) / 2;
+				while (g.head[cls] && count[cls] < want) {
+					free_block* b = g.head[cls];
+					g.head[cls] = b->next;
+					--g.count[cls];
+					b->next = head[cls];
+					head[cls] = b;
+					++count[cls];
+				}
+			}
+
+			// the global list is capped at a few thread caches worth of blocks; the rest is returned to the system
+			void give_back(std::size_t cls, std::size_t s) {
+				global_pool& g = global();
+				std::lock_guard<std::mutex> guard(g.lock[cls]);
+				for (; s && head[cls]; --s) {
+					free_block* b = head[cls];
+					head[cls] = b->next;
+					--count[cls];
+					if (g.count[cls] >= 8 * thread_cache_limit(cls)) {
+						release_block(b, cls);
+					}
+					else {
+						b->next = g.head[cls];
+						g.head[cls] = b;
+						++g.count[cls];
+					}
+				}
+			}
+		};
+
+		inline thread_cache& local() {
+			thread_local thread_cache cache;
+			return cache;
+		}
+
+		inline void* allocate_bytes(std::size_t bytes, std::size_t align) {
+			if (bytes > (std::size_t(1) << max_class_shift) || align > alignment) {
+				return ::operator new(bytes ? bytes : 1, std::align_val_t{ std::max(align, alignment) });
+			}
+			return local().pop(size_class(bytes));
+		}
+
+		inline void deallocate_bytes(void* p, std::size_t bytes, std::size_t align) {
+			if (!p) return;
+			if (bytes > (std::size_t(1) << max_class_shift) || align > alignment) {
+				::operator delete(p, std::align_val_t{ std::max(align, alignment) });
+				return;
+			}
+			local().push(p, size_class(bytes));
+		}
+	}
+	}
+
+	/*
+	 * allocation policies for matrix<T, Alloc>
+	 * a policy is a stateless type with static allocate<T>(n) / deallocate<T>(p, n); storage handed to matrix_take_ownership must come from the same policy
+	 * both policies fall back to std::allocator during constant evaluation (the two calls always agree, as constexpr allocations cannot leak out)
+	 */
+
+	// plain std::allocator; the historical behaviour
+	struct matrix_std_allocator {
 		template <typename T>
-		inline BHAVESH_CXX20_CONSTEXPR T* allocate(std::size_t s) {
+		static BHAVESH_CXX20_CONSTEXPR T* allocate(std::size_t s) {
 			return static_cast<T*>(std::allocator<T>{}.allocate(s));
 		}
+		template <typename T>
+		static BHAVESH_CXX20_CONSTEXPR void deallocate(T* ptr, std::size_t s) {
+			std::allocator<T>{}.deallocate(ptr, s);
+		}
+	};
+
+	// 64 byte (cache line / zmm) aligned blocks from per-thread size class pools; cheap churn of small and medium matrices
+	struct matrix_aligned_pool_allocator {
+		static constexpr std::size_t alignment = pool_detail::alignment;
+
+		template <typename T>
+		static BHAVESH_CXX20_CONSTEXPR T* allocate(std::size_t s) {
+#if BHAVESH_CXX20
+			if (std::is_constant_evaluated()) return std::allocator<T>{}.allocate(s);
+#endif
+			return static_cast<T*>(pool_detail::allocate_bytes(s * sizeof(T), alignof(T)));
+		}
+		template <typename T>
+		static BHAVESH_CXX20_CONSTEXPR void deallocate(T* ptr, std::size_t s) {
+#if BHAVESH_CXX20
+			if (std::is_constant_evaluated()) {
+				std::allocator<T>{}.deallocate(ptr, s);
+				return;
+			}
+#endif
+			pool_detail::deallocate_bytes(static_cast<void*>(ptr), s * sizeof(T), alignof(T));
+		}
+	};
+
+	/*
+	 * scoped bump-pointer arena for short lived matrices
+	 * constructing a matrix_arena makes it the current arena of the constructing thread (arenas nest); destroying it releases everything at once
+	 * matrices using matrix_arena_allocator take their storage from the current arena (or the heap when there is none),
+	 * so they must not outlive the arena and must be destroyed on the thread that created them
+	 * freeing allocations in LIFO order rolls the bump pointer back, which keeps construction_holder's rollback and chains of temporaries cheap
+	 */
+	class matrix_arena {
+	public:
+		static constexpr std::size_t alignment = 64;
+
+		explicit matrix_arena(std::size_t chunk_bytes = std::size_t(1) << 20) : chunk_bytes(chunk_bytes), previous(current()) {
+			current() = this;
+		}
+		matrix_arena(const matrix_arena&) = delete;
+		matrix_arena& operator=(const matrix_arena&) = delete;
+		~matrix_arena() {
+			while (head) {
+				chunk* c = head;
+				head = c->prev;
+				::operator delete(static_cast<void*>(c), std::align_val_t{ alignment });
+			}
+			current() = previous;
+		}
+
+		// nullptr for 0 bytes: the bump pointer of an exactly full chunk is one past its end, which owns() would not recognize later
+		void* allocate(std::size_t bytes) {
+			if (bytes == 0) return nullptr;
+			bytes = (bytes + alignment - 1) / alignment * alignment;
+			if (!head || static_cast<std::size_t>(end - cur) < bytes) grow(bytes);
+			void* p = cur;
+			cur += bytes;
+			return p;
+		}
+
+		// returns false when p did not come from this arena; there is nothing to release for a zero-size allocation
+		bool deallocate(void* p, std::size_t bytes) noexcept {
+			if (!p || bytes == 0) return true;
+			if (!owns(p)) return false;
+			bytes = (bytes + alignment - 1) / alignment * alignment;
+			if (static_cast<char*>(p) + bytes == cur) cur = static_cast<char*>(p);
+			return true;
+		}
+
+		bool owns(const void* p) const noexcept {
+			for (const chunk* c = head; c; c = c->prev) {
+				const char* data = reinterpret_cast<const char*>(c) + header_bytes;
+				if (std::less_equal<const char*>{}(data, static_cast<const char*>(p)) && std::less<const char*>{}(static_cast<const char*>(p), data + c->size)) return true;
+			}
+			return false;
+		}
 
+		std::size_t bytes_reserved() const noexcept {
+			std::size_t s = 0;
+			for (const chunk* c = head; c; c = c->prev) s += c->size;
+			return s;
+		}
+
+		matrix_arena* enclosing() const noexcept { return previous; }
+
+		static matrix_arena*& current() noexcept {
+			thread_local matrix_arena* arena = nullptr;
+			return arena;
+		}
+
+	private:
+		struct chunk {
+			chunk* prev;
+			std::size_t size;
+		};
+		static constexpr std::size_t header_bytes = (sizeof(chunk) + alignment - 1) / alignment * alignment;
+
+		// chunks double in size so the chunk list stays short
+		void grow(std::size_t bytes) {
+			std::size_t size = head ? head->size * 2 : chunk_bytes;
+			if (size < bytes) size = bytes;
+			chunk* c = static_cast<chunk*>(::operator new(header_bytes + size, std::align_val_t{ alignment }));
+			c->prev = head;
+			c->size = size;
+			head = c;
+			cur = reinterpret_cast<char*>(c) + header_bytes;
+			end = cur + size;
+		}
+
+		std::size_t chunk_bytes;
+		matrix_arena* previous;
+		chunk* head = nullptr;
+		char* cur = nullptr;
+		char* end = nullptr;
+	};
+
+	// storage from matrix_arena::current(); with no arena active it behaves like an aligned heap allocation
+	struct matrix_arena_allocator {
+		template <typename T>
+		static BHAVESH_CXX20_CONSTEXPR T* allocate(std::size_t s) {
+#if BHAVESH_CXX20
+			if (std::is_constant_evaluated()) return std::allocator<T>{}.allocate(s);
+#endif
+			static_assert(alignof(T) <= matrix_arena::alignment, "over-aligned types are not supported by matrix_arena_allocator");
+			if (s == 0) return nullptr;
+			if (matrix_arena* arena = matrix_arena::current()) return static_cast<T*>(arena->allocate(s * sizeof(T)));
+			return static_cast<T*>(::operator new(s * sizeof(T), std::align_val_t{ matrix_arena::alignment }));
+		}
 		template <typename T>
+		static BHAVESH_CXX20_CONSTEXPR void deallocate(T* ptr, std::size_t s) {
+#if BHAVESH_CXX20
+			if (std::is_constant_evaluated()) {
+				std::allocator<T>{}.deallocate(ptr, s);
+				return;
+			}
+#endif
+			if (!ptr || s == 0) return;
+			for (matrix_arena* arena = matrix_arena::current(); arena; arena = arena->enclosing()) {
+				if (arena->deallocate(static_cast<void*>(ptr), s * sizeof(T))) return;
+			}
+			::operator delete(static_cast<void*>(ptr), std::align_val_t{ matrix_arena::alignment });
+		}
+	};
+
+#ifndef BHAVESH_MATRIX_THREADS
+# define BHAVESH_MATRIX_THREADS 0 // total threads the parallel kernels use (the calling thread included); 0 means one per logical cpu
+#endif
+#ifndef BHAVESH_MATRIX_PIN_THREADS
+# define BHAVESH_MATRIX_PIN_THREADS false
+#endif
+#ifndef BHAVESH_MATRIX_PARALLEL_THRESHOLD
+# define BHAVESH_MATRIX_PARALLEL_THRESHOLD (std::size_t(1) << 16) // elements; smaller operations stay on the calling thread
+#endif
+
+	inline namespace detail {
+	namespace sched_detail {
+		/*
+		 * work-stealing pool behind the parallel kernels
+		 * every thread owns a deque: it pops its own work from the back and, once that runs dry, steals from the front of the others
+		 * parallel_for(count, f) deals the indices out to the deques in contiguous runs (so neighbouring tiles start out on one thread),
+		 * then the calling thread joins in until all of them are done; a parallel_for issued from inside a task simply runs inline
+		 * with BHAVESH_MATRIX_PIN_THREADS each worker is bound to one logical cpu, which keeps the panels it packs in its own caches and numa node
+		 */
+
+		struct job {
+			void (*run)(void*, std::size_t);
+			void* fn;
+			std::atomic<std::size_t> remaining;
+			std::exception_ptr error;
+			std::mutex error_lock;
+		};
+
+		struct task {
+			job* owner;
+			std::size_t index;
+		};
+
+		class work_deque {
+		public:
+			void push(job* owner, std::size_t first, std::size_t last) {
+				std::lock_guard<std::mutex> lock(m_lock);
+				for (std::size_t i = first; i != last; ++i) m_tasks.push_back(task{ owner, i });
+			}
+			bool pop(task& t) {
+				std::lock_guard<std::mutex> lock(m_lock);
+				if (m_tasks.empty()) return false;
+				t = m_tasks.back();
+				m_tasks.pop_back();
+				return true;
+			}
+			bool steal(task& t) {
+				std::lock_guard<std::mutex> lock(m_lock);
+				if (m_tasks.empty()) return false;
+				t = m_tasks.front();
+				m_tasks.pop_front();
+				return true;
+			}
+		private:
+			std::mutex m_lock;
+			std::deque<task> m_tasks;
+		};
+
+		inline bool& inside_task() noexcept {
+			thread_local bool inside = false;
+			return inside;
+		}
+
+		inline void pin_to_cpu(std::thread& t, std::size_t cpu) {
+#		if BHAVESH_MATRIX_PIN_THREADS && defined(_WIN32)
+			SetThreadAffinityMask(t.native_handle(), DWORD_PTR(1) << (cpu % (8 * sizeof(DWORD_PTR))));
+#		elif BHAVESH_MATRIX_PIN_THREADS && defined(__linux__)
+			cpu_set_t set;
+			CPU_ZERO(&set);
+			CPU_SET(static_cast<int>(cpu % CPU_SETSIZE), &set);
+			pthread_setaffinity_np(t.native_handle(), sizeof(set), &set);
+#		else
+			static_cast<void>(t);
+			static_cast<void>(cpu);
+#		endif
+		}
+
+		class scheduler {
+		public:
+			static scheduler& instance() {
+				static scheduler s(default_threads());
+				return s;
+			}
+
+			static std::size_t default_threads() noexcept {
+				const std::size_t hw = std::thread::hardware_concurrency();
+				return BHAVESH_MATRIX_THREADS ? BHAVESH_MATRIX_THREADS : (hw ? hw : 1);
+			}
+
+			// joins the current workers and starts threads - 1 new ones; nothing may be running on the pool meanwhile
+			void configure(std::size_t threads) {
+				stop();
+				m_stopping = false;
+				m_deques = std::vector<work_deque>(threads ? threads : 1);
+				start();
+			}
+
+			scheduler(const scheduler&) = delete;
+			scheduler& operator=(const scheduler&) = delete;
+			~scheduler() { stop(); }
+
+			// threads a parallel_for runs on, the caller included
+			std::size_t concurrency() const noexcept { return m_workers.size() + 1; }
+
+			template <typename F>
+			void parallel_for(std::size_t count, F&& f) {
+				if (count == 0) return;
+				if (count == 1 || m_workers.empty() || inside_task()) {
+					for (std::size_t i = 0; i != count; ++i) f(i);
+					return;
+				}
+
+				job j{ [](void* fn, std::size_t i) { (*static_cast<std::remove_reference_t<F>*>(fn))(i); }, const_cast<void*>(static_cast<const void*>(std::addressof(f))), { count }, nullptr, {} };
+				const std::size_t slots = m_deques.size();
+				m_queued.fetch_add(count);
+				for (std::size_t s = 0; s != slots; ++s) {
+					m_deques[s].push(&j, count * s / slots, count * (s + 1) / slots);
+				}
+				{ std::lock_guard<std::mutex> lock(m_wake_lock); }
+				m_wake.notify_all();
+
+				// the caller works from deque 0 (shared by every outside thread) and steals like any worker until its job is through
+				inside_task() = true;
+				while (j.remaining.load(std::memory_order_acquire) != 0) {
+					task t;
+					if (find(0, t)) {
+						run(t);
+						continue;
+					}
+					std::unique_lock<std::mutex> lock(m_done_lock);
+					m_done.wait(lock, [&j] { return j.remaining.load(std::memory_order_acquire) == 0; });
+				}
+				inside_task() = false;
+				if (j.error) std::rethrow_exception(j.error);
+			}
+
+		private:
+			explicit scheduler(std::size_t threads) : m_deques(threads ? threads : 1) {
+				start();
+			}
+
+			void start() {
+				m_workers.reserve(m_deques.size() - 1);
+				for (std::size_t w = 1; w != m_deques.size(); ++w) {
+					m_workers.emplace_back([this, w] { work(w); });
+					pin_to_cpu(m_workers.back(), w);
+				}
+			}
+
+			void stop() {
+				{
+					std::lock_guard<std::mutex> lock(m_wake_lock);
+					m_stopping = true;
+				}
+				m_wake.notify_all();
+				for (std::thread& t : m_workers) t.join();
+				m_workers.clear();
+			}
+
+			bool find(std::size_t self, task& t) {
+				if (m_deques[self].pop(t)) {
+					m_queued.fetch_sub(1);
+					return true;
+				}
+				for (std::size_t s = 1; s != m_deques.size(); ++s) {
+					if (m_deques[(self + s) % m_deques.size()].steal(t)) {
+						m_queued.fetch_sub(1);
+						return true;
+					}
+				}
+				return false;
+			}
+
+			void run(const task& t) {
+				job& j = *t.owner;
+				try {
+					j.run(j.fn, t.index);
+				}
+				catch (...) {
+					std::lock_guard<std::mutex> lock(j.error_lock);
+					if (!j.error) j.error = std::current_exception();
+				}
+				if (j.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) { // j may be gone as soon as this lands
+					{ std::lock_guard<std::mutex> lock(m_done_lock); }
+					m_done.notify_all();
+				}
+			}
+
+			void work(std::size_t self) {
+				inside_task() = true;
+				for (;;) {
+					task t;
+					if (find(self, t)) {
+						run(t);
+						continue;
+					}
+					std::unique_lock<std::mutex> lock(m_wake_lock);
+					m_wake.wait(lock, [this] { return m_stopping || m_queued.load() != 0; });
+					if (m_stopping) return;
+				}
+			}
+
+			std::vector<work_deque> m_deques; // [0] is fed by outside callers, [w] by worker w
+			std::vector<std::thread> m_workers;
+			std::atomic<std::size_t> m_queued{ 0 };
+			std::mutex m_wake_lock;
+			std::condition_variable m_wake;
+			bool m_stopping = false;
+			std::mutex m_done_lock;
+			std::condition_variable m_done;
+		};
+
+		inline std::atomic<std::size_t>& threshold() noexcept {
+			static std::atomic<std::size_t> elements{ BHAVESH_MATRIX_PARALLEL_THRESHOLD };
+			return elements;
+		}
+
+		// whether work over s elements should be spread over the pool
+		inline bool worth_splitting(std::size_t s) noexcept {
+			return s >= threshold().load(std::memory_order_relaxed) && !inside_task() && scheduler::instance().concurrency() > 1;
+		}
+
+		// f(first, last) over [0, s), cut into a few ranges per thread when s (times the per item cost in elements) reaches the threshold;
+		// cuts fall on 64 byte boundaries of T
+		template <typename T, typename F>
+		inline void for_ranges(std::size_t s, F&& f, std::size_t cost = 1) {
+			if (!worth_splitting(s * cost)) {
+				f(std::size_t(0), s);
+				return;
+			}
+			constexpr std::size_t align = sizeof(T) < 64 ? 64 / sizeof(T) : 1;
+			const std::size_t chunks = 4 * scheduler::instance().concurrency();
+			const auto cut = [s, chunks](std::size_t c) { return c == chunks ? s : s * c / chunks / align * align; };
+			scheduler::instance().parallel_for(chunks, [&f, &cut](std::size_t c) {
+				const std::size_t first = cut(c), last = cut(c + 1);
+				if (first != last) f(first, last);
+			});
+		}
+	}
+	}
+
+	/*
+	 * library-wide parallelism settings
+	 * elementwise arithmetic, conversions, copies, transposes and products over at least threshold() elements are split across a pool of
+	 * thread_count() threads owned by the library (the calling thread counts as one), independent of the standard library's parallel backend
+	 * thread_count() == 1 keeps everything on the calling thread; reconfigure only while no matrix operation is running
+	 */
+	class matrix_scheduler {
+	public:
+		matrix_scheduler() = delete;
+
+		static std::size_t thread_count() { return sched_detail::scheduler::instance().concurrency(); }
+		// 0 goes back to BHAVESH_MATRIX_THREADS, or one thread per logical cpu
+		static void set_thread_count(std::size_t threads) {
+			sched_detail::scheduler::instance().configure(threads ? threads : sched_detail::scheduler::default_threads());
+		}
+
+		static std::size_t threshold() noexcept { return sched_detail::threshold().load(std::memory_order_relaxed); }
+		static void set_threshold(std::size_t elements) noexcept { sched_detail::threshold().store(elements, std::memory_order_relaxed); }
+
+		// f(i) for every i in [0, count) on the pool; returns once all are done and rethrows the first exception any of them threw
+		template <typename F>
+		static void parallel_for(std::size_t count, F&& f) { sched_detail::scheduler::instance().parallel_for(count, f); }
+	};
+
+#ifndef BHAVESH_MATRIX_DEFAULT_ALLOCATOR
+# define BHAVESH_MATRIX_DEFAULT_ALLOCATOR ::bhavesh::matrix_std_allocator
+#endif
+
+	inline namespace detail {
+	namespace matrix_detail {
+
+		// wrappers for easier access + more readability
+		template <typename T, typename Alloc = BHAVESH_MATRIX_DEFAULT_ALLOCATOR>
+		inline BHAVESH_CXX20_CONSTEXPR T* allocate(std::size_t s) {
+			return Alloc::template allocate<T>(s);
+		}
+
+		template <typename T, typename Alloc = BHAVESH_MATRIX_DEFAULT_ALLOCATOR>
 		inline BHAVESH_CXX20_CONSTEXPR void deallocate(T* ptr, std::size_t s) {
-			std::allocator<T>{}.deallocate(ptr, s);
+			Alloc::template deallocate<T>(ptr, s);
 		}
 
 #   if BHAVESH_CXX20
@@ -162,34 +754,74 @@ namespace bhavesh {
 			(construct_at)(ptr /* no arguments */);
 		}
 
+		// lets the fast (non-constexpr) paths bail out during constant evaluation; nothing is constexpr before C++20 anyways
+		constexpr bool is_constant_evaluated() noexcept {
+#   if BHAVESH_CXX20
+			return std::is_constant_evaluated();
+#   else
+			return false;
+#   endif
+		}
+
 		// exception type; should be self-explanatory
 		class incompletely_initialized : public std::runtime_error { using runtime_error::runtime_error; constexpr incompletely_initialized() = delete; };
 
+		/*
+		 * inline storage inside matrix<T> for shapes with at most small_buffer_capacity<T> elements (no heap allocation at all)
+		 * only trivial T qualify (moving the buffer is then a plain copy and nothing needs destroying); never used during constant evaluation
+		 * BHAVESH_MATRIX_SMALL_BUFFER_BYTES = 0 turns it off and the buffer takes no space
+		 */
+#ifndef BHAVESH_MATRIX_SMALL_BUFFER_BYTES
+#	define BHAVESH_MATRIX_SMALL_BUFFER_BYTES 64
+#endif
+#if defined(_MSC_VER) && !defined(__clang__)
+#	define BHAVESH_NO_UNIQUE_ADDRESS [[msvc::no_unique_address]]
+#else
+#	define BHAVESH_NO_UNIQUE_ADDRESS [[no_unique_address]]
+#endif
+
+		template <typename T>
+		struct small_buffer_capacity : std::integral_constant<std::size_t, std::is_trivial<T>::value ? BHAVESH_MATRIX_SMALL_BUFFER_BYTES / sizeof(T) : 0> {};
+
+		template <typename T, std::size_t Cap = small_buffer_capacity<T>::value>
+		struct small_buffer {
+			BHAVESH_CXX20_CONSTEXPR T* data() noexcept { return buf; }
+			BHAVESH_CXX20_CONSTEXPR const T* data() const noexcept { return buf; }
+			T buf[Cap]; // deliberately left uninitialized
+		};
+		template <typename T>
+		struct small_buffer<T, 0> {
+			constexpr T* data() const noexcept { return nullptr; }
+		};
+
 		// responsible for memory during construction; works kinda-like a mix of unique_ptr<T[]> and std::vector<T> with more crazy stuff
-		template<typename T>
+		// an external buffer (the small buffer of the matrix being built) may be handed in; it is then used as-is and never deallocated
+		template<typename T, typename Alloc = BHAVESH_MATRIX_DEFAULT_ALLOCATOR>
 		class construction_holder {
 		public:
 			BHAVESH_CXX20_CONSTEXPR explicit construction_holder() : start(nullptr), size(0), capacity(0) {}
-			BHAVESH_CXX20_CONSTEXPR explicit construction_holder(std::size_t s) : start((allocate<T>)(s)), size(0), capacity(s) {}
-			BHAVESH_CXX20_CONSTEXPR explicit construction_holder(std::size_t m, std::size_t n) : construction_holder(m * n) {}
+			BHAVESH_CXX20_CONSTEXPR explicit construction_holder(std::size_t s, T* buffer = nullptr) : start(buffer ? buffer : (allocate<T, Alloc>)(s)), size(0), capacity(s), owned(!buffer) {}
+			BHAVESH_CXX20_CONSTEXPR explicit construction_holder(std::size_t m, std::size_t n, T* buffer = nullptr) : construction_holder(m * n, buffer) {}
 			BHAVESH_CXX20_CONSTEXPR construction_holder(const construction_holder&) = delete;
-			BHAVESH_CXX20_CONSTEXPR construction_holder(construction_holder&& oth) 
-				:	start(std::exchange(oth.start, nullptr)), 
-					size(std::exchange(oth.size, 0)), 
-					capacity(std::exchange(oth.capacity, 0)) {};
+			BHAVESH_CXX20_CONSTEXPR construction_holder(construction_holder&& oth)
+				:	start(std::exchange(oth.start, nullptr)),
+					size(std::exchange(oth.size, 0)),
+					capacity(std::exchange(oth.capacity, 0)),
+					owned(oth.owned) {};
 			BHAVESH_CXX20_CONSTEXPR construction_holder& operator=(const construction_holder&) = delete;
 			BHAVESH_CXX20_CONSTEXPR construction_holder& operator=(construction_holder&& oth) {
 				if (this == &oth) return *this;
 				start = std::exchange(oth.start, nullptr);
 				size = std::exchange(oth.size, 0);
 				capacity = std::exchange(oth.capacity, 0);
+				owned = oth.owned;
 				return *this;
 			}
 
 			BHAVESH_CXX20_CONSTEXPR ~construction_holder() {
 				if (start) {
 					destroy_n(start, size);
-					deallocate(start, capacity);
+					if (owned) (deallocate<T, Alloc>)(start, capacity);
 					start = nullptr;
 					size = capacity = 0;
 				}
@@ -218,8 +850,8 @@ namespace bhavesh {
 					return;
 				}
 #endif
-				std::memset(static_cast<void*>(start + size), 0, (capacity - size) * sizeof(T));
-				capacity = size;
+				if (size != capacity) std::memset(static_cast<void*>(start + size), 0, (capacity - size) * sizeof(T)); // start is null when empty
+				size = capacity;
 			}
 
 			template <typename X = T, std::enable_if_t<!std::is_trivially_default_constructible<X>::value, int> = 0>
@@ -234,7 +866,7 @@ namespace bhavesh {
 					return;
 				}
 #endif
-				std::memset(static_cast<void*>(start + size), 0, s * sizeof(T));
+				if (s) std::memset(static_cast<void*>(start + size), 0, s * sizeof(T));
 				size += s;
 			}
 
@@ -255,9 +887,19 @@ namespace bhavesh {
 					return;
 				}
 #endif
-				std::memcpy(static_cast<void*>(start + size), static_cast<const void*>(ptr), std::min(capacity - size, s) * sizeof(T));
+				const std::size_t x = std::min(capacity - size, s);
+				if (x == 0) return;
+				T* const dst = start + size;
+				sched_detail::for_ranges<T>(x, [dst, ptr](std::size_t first, std::size_t last) {
+					std::memcpy(static_cast<void*>(dst + first), static_cast<const void*>(ptr + first), (last - first) * sizeof(T));
+				});
+				size += x;
 			}
 
+			// raw access for bulk kernels that write straight into storage; only meaningful for trivially copyable T, and commit() must follow the writes
+			BHAVESH_CXX20_CONSTEXPR T* uninitialized_data() { return start + size; }
+			BHAVESH_CXX20_CONSTEXPR void commit(std::size_t s) { size += s; }
+
 
 			template<bool suppress_check=!BHAVESH_DEBUG>
 			BHAVESH_CXX20_CONSTEXPR T* release() {
@@ -275,19 +917,21 @@ namespace bhavesh {
 			T* start;
 			std::size_t size;
 			std::size_t capacity;
+			bool owned = true;
 		};
 
 		// I allow users to give me the transpose of a matrix and i will transpose it again for them; this is what will be used during construction (like construction_holder)
-		template<typename T>
+		template<typename T, typename Alloc = BHAVESH_MATRIX_DEFAULT_ALLOCATOR>
 		class construction_holder_transpose {
 		public:
 			explicit BHAVESH_CXX20_CONSTEXPR construction_holder_transpose() : start(nullptr), m(0), n(0) {}
-			explicit BHAVESH_CXX20_CONSTEXPR construction_holder_transpose(std::size_t m, std::size_t n) : start((allocate<T>)(m*n)), m(m), n(n) {}
+			explicit BHAVESH_CXX20_CONSTEXPR construction_holder_transpose(std::size_t m, std::size_t n, T* buffer = nullptr) : start(buffer ? buffer : (allocate<T, Alloc>)(m*n)), m(m), n(n), owned(!buffer) {}
 			BHAVESH_CXX20_CONSTEXPR construction_holder_transpose(const construction_holder_transpose&) = delete;
 			BHAVESH_CXX20_CONSTEXPR construction_holder_transpose(construction_holder_transpose&& oth)
 				:	start(std::exchange(oth.start, nullptr)),
 					i(std::exchange(oth.i, 0)), j(std::exchange(oth.j, 0)),
-					m(std::exchange(oth.m, 0)), n(std::exchange(oth.n, 0)) {}
+					m(std::exchange(oth.m, 0)), n(std::exchange(oth.n, 0)),
+					owned(oth.owned) {}
 			BHAVESH_CXX20_CONSTEXPR construction_holder_transpose& operator=(const construction_holder_transpose&) = delete;
 			BHAVESH_CXX20_CONSTEXPR construction_holder_transpose& operator=(construction_holder_transpose&& oth) {
 				if (this == &oth) return *this;
@@ -296,6 +940,7 @@ namespace bhavesh {
 				j = std::exchange(oth.j, 0);
 				m = std::exchange(oth.m, 0);
 				n = std::exchange(oth.n, 0);
+				owned = oth.owned;
 				return *this;
 			}
 
@@ -307,7 +952,7 @@ namespace bhavesh {
 					for (std::size_t x = i; x != m; ++x) {
 						destroy_n(start + x * n, j);
 					}
-					deallocate(start, m*n);
+					if (owned) (deallocate<T, Alloc>)(start, m*n);
 					start = nullptr;
 					i = j = m = n = 0;
 				}
@@ -392,21 +1037,31 @@ namespace bhavesh {
 			T* start;
 			std::size_t i=0, j=0;
 			std::size_t m, n;
+			bool owned = true;
 		};
 
-		template<typename T, bool is_transpose>
-		using holder = std::conditional_t<is_transpose, construction_holder_transpose<T>, construction_holder<T>>;
+		template<typename T, bool is_transpose, typename Alloc = BHAVESH_MATRIX_DEFAULT_ALLOCATOR>
+		using holder = std::conditional_t<is_transpose, construction_holder_transpose<T, Alloc>, construction_holder<T, Alloc>>;
 
-		template <typename T>
-		inline BHAVESH_CXX20_CONSTEXPR T* create_default_n(std::size_t s) {
-			construction_holder<T> h(s);
+		template <typename T, typename Alloc = BHAVESH_MATRIX_DEFAULT_ALLOCATOR>
+		inline BHAVESH_CXX20_CONSTEXPR T* create_default_n(std::size_t s, T* buffer = nullptr) {
+			construction_holder<T, Alloc> h(s, buffer);
 			h.fill_default();
 			return h.release<true>();
 		}
 
-		template <typename T>
-		inline BHAVESH_CXX20_CONSTEXPR T* create_fill_n(std::size_t s, const T& val) {
-			construction_holder<T> h(s);
+		// storage for s elements; trivial types are left unconstructed outside constant evaluation
+		template <typename T, typename Alloc = BHAVESH_MATRIX_DEFAULT_ALLOCATOR>
+		inline BHAVESH_CXX20_CONSTEXPR T* create_uninitialized_n(std::size_t s, T* buffer = nullptr) {
+			if BHAVESH_CXX17_CONSTEXPR(std::is_trivial<T>::value) {
+				if (!is_constant_evaluated()) return buffer ? buffer : allocate<T, Alloc>(s);
+			}
+			return create_default_n<T, Alloc>(s, buffer);
+		}
+
+		template <typename T, typename Alloc = BHAVESH_MATRIX_DEFAULT_ALLOCATOR>
+		inline BHAVESH_CXX20_CONSTEXPR T* create_fill_n(std::size_t s, const T& val, T* buffer = nullptr) {
+			construction_holder<T, Alloc> h(s, buffer);
 			for (std::size_t i = 0; i != s; ++i) {
 				h.emplace_back(val);
 			}
@@ -415,9 +1070,9 @@ namespace bhavesh {
 
 
 
-		template <silence_t sil, bool is_transpose, typename T>
-		inline BHAVESH_CXX20_CONSTEXPR T* create_from_il(std::size_t m, std::size_t n, std::initializer_list<T> il) {
-			holder<T, is_transpose> h(m, n);
+		template <silence_t sil, bool is_transpose, typename T, typename Alloc = BHAVESH_MATRIX_DEFAULT_ALLOCATOR>
+		inline BHAVESH_CXX20_CONSTEXPR T* create_from_il(std::size_t m, std::size_t n, std::initializer_list<T> il, T* buffer = nullptr) {
+			holder<T, is_transpose, Alloc> h(m, n, buffer);
 			if BHAVESH_CXX17_CONSTEXPR((sil & silence_t::silence_less) == 0) if (il.size() < m * n) throw std::invalid_argument( "too few arguments given to matrix(m, n, { ... })");
 			if BHAVESH_CXX17_CONSTEXPR((sil & silence_t::silence_more) == 0) if (il.size() > m * n) throw std::invalid_argument("too many arguments given to matrix(m, n, { ... })");
 			h.copy_from(il.begin(), il.size());
@@ -425,16 +1080,16 @@ namespace bhavesh {
 			return h.release<true>();
 		}
 
-		template <bool is_transpose, typename T>
-		BHAVESH_CXX20_CONSTEXPR T* create_from_matrix(std::size_t m, std::size_t n, T* mat) {
-			holder<T, is_transpose> h(m, n);
+		template <bool is_transpose, typename T, typename Alloc = BHAVESH_MATRIX_DEFAULT_ALLOCATOR>
+		BHAVESH_CXX20_CONSTEXPR T* create_from_matrix(std::size_t m, std::size_t n, const T* mat, T* buffer = nullptr) {
+			holder<T, is_transpose, Alloc> h(m, n, buffer);
 			h.copy_from(mat, m*n);
 			return h.release<true>();
 		}
 
-		template <silence_t sil, bool is_transpose, typename T>
-		inline BHAVESH_CXX20_CONSTEXPR T* create_from_ilil(std::size_t m, std::size_t n, std::initializer_list<std::initializer_list<T>> il) {
-			std::conditional_t<is_transpose, construction_holder_transpose<T>, construction_holder<T>> h(m, n);
+		template <silence_t sil, bool is_transpose, typename T, typename Alloc = BHAVESH_MATRIX_DEFAULT_ALLOCATOR>
+		inline BHAVESH_CXX20_CONSTEXPR T* create_from_ilil(std::size_t m, std::size_t n, std::initializer_list<std::initializer_list<T>> il, T* buffer = nullptr) {
+			holder<T, is_transpose, Alloc> h(m, n, buffer);
 			if BHAVESH_CXX17_CONSTEXPR(is_transpose) std::swap(m, n);
 			if BHAVESH_CXX17_CONSTEXPR((sil & silence_t::silence_less) == 0) if (il.size() < m) throw std::invalid_argument( "too few arguments given to matrix(m, n, { ... })");
 			if BHAVESH_CXX17_CONSTEXPR((sil & silence_t::silence_more) == 0) if (il.size() > m) throw std::invalid_argument("too many arguments given to matrix(m, n, { ... })");
@@ -463,8 +1118,8 @@ namespace bhavesh {
 		template <typename R, typename T>
 		concept matrix_compatible_range = compatible_linear_range<R, T> || compatible_tabular_range<R, T>;
 
-		template<silence_t sil, bool fill_all, typename T, template <typename> typename holder, compatible_linear_range<T> R>
-		constexpr inline void take_n_from(holder<T>& h, std::size_t n, R&& rng) {
+		template<silence_t sil, bool fill_all, typename T, typename Alloc, template <typename, typename> typename holder, compatible_linear_range<T> R>
+		constexpr inline void take_n_from(holder<T, Alloc>& h, std::size_t n, R&& rng) {
 			if constexpr (std::ranges::sized_range<R>) {
 				const std::size_t x = std::ranges::size(rng);
 				if constexpr ((sil & silence_t::silence_less) == 0) if (x < n) throw std::invalid_argument( "too few arguments given to matrix(from_range, m, n, { ... })");
@@ -498,16 +1153,16 @@ namespace bhavesh {
 			}
 		}
 
-		template<silence_t sil, bool is_transpose, typename T, compatible_linear_range<T> R>
-		constexpr inline T* create_from_range(std::size_t m, std::size_t n, R&& rng) {
-			std::conditional_t<is_transpose, construction_holder_transpose<T>, construction_holder<T>> h(m, n);
+		template<silence_t sil, bool is_transpose, typename T, typename Alloc, compatible_linear_range<T> R>
+		constexpr inline T* create_from_range(std::size_t m, std::size_t n, R&& rng, T* buffer = nullptr) {
+			holder<T, is_transpose, Alloc> h(m, n, buffer);
 			take_n_from<sil, true>(h, m * n, std::forward<R>(rng));
 			return h.release<true>();
 		}
 
-		template<silence_t sil, bool is_transpose, typename T, compatible_tabular_range<T> R>
-		constexpr inline T* create_from_range(std::size_t m, std::size_t n, R&& rng) {
-			std::conditional_t<is_transpose, construction_holder_transpose<T>, construction_holder<T>> h(m, n);
+		template<silence_t sil, bool is_transpose, typename T, typename Alloc, compatible_tabular_range<T> R>
+		constexpr inline T* create_from_range(std::size_t m, std::size_t n, R&& rng, T* buffer = nullptr) {
+			holder<T, is_transpose, Alloc> h(m, n, buffer);
 			if constexpr (is_transpose) std::swap(m, n);
 
 			if constexpr (std::ranges::sized_range<R>) {
@@ -544,42 +1199,1177 @@ namespace bhavesh {
 	}
 	}
 
-	inline namespace iterators {
-	namespace matrix_iterators {
+	inline namespace detail {
+	namespace gemm_detail {
+		/*
+		 * blocked gemm in the usual goto/blis shape:
+		 *     for jc (NC columns of C) -> for pc (KC depth, pack B) -> for ic (MC rows of C, pack A) -> for jr -> for ir -> micro kernel
+		 * a packed MC x KC block of A lives in L2, a KC x NR sliver of packed B lives in L1, and the MR x NR block of C stays in registers
+		 * everything takes (row stride, column stride) pairs so that any strided layout can be fed in without copying first
+		 */
+
+#	if defined(__AVX512F__)
+		constexpr std::size_t simd_bytes = 64;
+#	elif defined(__AVX__)
+		constexpr std::size_t simd_bytes = 32;
+#	else
+		constexpr std::size_t simd_bytes = 16;
+#	endif
 
-		template <typename T, typename _tag>
-		class _row_iterator {
-		public:
-			using value_type = std::remove_cv_t<T>;
-			using element_type = T;
-			using difference_type = ptrdiff_t;
-			using reference = T&;
-			using const_reference = const T&;
-			using pointer = T*;
-			using const_pointer = const T*;
-#if BHAVESH_CXX_VER >= 202002L
-			using iterator_category = std::contiguous_iterator_tag;
-			using iterator_concept = std::contiguous_iterator_tag;
-#else
-			using iterator_category = std::random_access_iterator_tag;
-#endif
+		template <typename T>
+		struct blocking {
+			// two vector registers per row of the micro tile; 6 rows when there are 16+ vector registers to spare (AVX and up), 4 otherwise
+			static constexpr std::size_t NR = (2 * simd_bytes / sizeof(T)) ? (2 * simd_bytes / sizeof(T)) : 1;
+			static constexpr std::size_t MR = (simd_bytes >= 32) ? 6 : 4;
+			static constexpr std::size_t KC = 256;
+			static constexpr std::size_t MC = 120;  // multiple of both possible MRs
+			static constexpr std::size_t NC = 3072; // multiple of every possible NR
+		};
+
+		template <typename T, typename By, typename To>
+		struct use_blocked_gemm : std::integral_constant<bool,
+			std::is_arithmetic<T>::value && !std::is_same<T, bool>::value && std::is_same<T, By>::value && std::is_same<T, To>::value> {};
+
+		// 64 byte aligned scratch for the packed panels; T is always arithmetic here so no construction is needed
+		template <typename T>
+		class aligned_buffer {
 		public:
-			constexpr _row_iterator() = default;
-			constexpr _row_iterator(T* data) : m_data(data) {}
-			constexpr _row_iterator(const _row_iterator&) = default;
-			constexpr _row_iterator(_row_iterator&&) = default;
-			constexpr _row_iterator& operator=(const _row_iterator&) = default;
-			constexpr _row_iterator& operator=(_row_iterator&&) = default;
+			explicit aligned_buffer(std::size_t s) : m_data(static_cast<T*>(::operator new(s * sizeof(T), std::align_val_t{ 64 }))) {}
+			aligned_buffer(const aligned_buffer&) = delete;
+			aligned_buffer& operator=(const aligned_buffer&) = delete;
+			~aligned_buffer() { ::operator delete(static_cast<void*>(m_data), std::align_val_t{ 64 }); }
 
-			template<typename=std::enable_if_t<!std::is_const<T>::value>>
-			constexpr operator _row_iterator<const T, _tag>() {
-				return _row_iterator<const T, _tag>(static_cast<const T*>(m_data));
+			T* data() const { return m_data; }
+		private:
+			T* m_data;
+		};
+
+		// packing space for gemm, kept per thread and only ever grown, since the parallel driver calls gemm once per tile of C
+		template <typename T>
+		inline T* scratch(std::size_t s) {
+			thread_local std::unique_ptr<aligned_buffer<T>> buf;
+			thread_local std::size_t capacity = 0;
+			if (capacity < s) {
+				buf.reset();
+				buf.reset(new aligned_buffer<T>(s));
+				capacity = s;
 			}
+			return buf->data();
+		}
 
-		public:
-#if BHAVESH_CXX_VER >= 202002L
-			constexpr std::strong_ordering operator<=>(const _row_iterator& it) const { return m_data <=> it.m_data; }
-			constexpr bool operator==(const _row_iterator&) const = default;
+		// A[mc x kc] -> MR-row slivers, each stored k-major; ragged last sliver is zero padded so the micro kernel never branches
+		template <typename T, std::size_t MR>
+		inline void pack_a(std::size_t mc, std::size_t kc, const T* a, std::ptrdiff_t rsa, std::ptrdiff_t csa, T* buf) {
+			for (std::size_t ir = 0; ir < mc; ir += MR) {
+				const std::size_t mr = std::min(MR, mc - ir);
+				const T* src = a + static_cast<std::ptrdiff_t>(ir) * rsa;
+				for (std::size_t p = 0; p != kc; ++p) {
+					const T* col = src + static_cast<std::ptrdiff_t>(p) * csa;
+					std::size_t i = 0;
+					for (; i != mr; ++i) buf[i] = col[static_cast<std::ptrdiff_t>(i) * rsa];
+					for (; i != MR; ++i) buf[i] = T{};
+					buf += MR;
+				}
+			}
+		}
+
+		// B[kc x nc] -> NR-column slivers, each stored k-major
+		template <typename T, std::size_t NR>
+		inline void pack_b(std::size_t kc, std::size_t nc, const T* b, std::ptrdiff_t rsb, std::ptrdiff_t csb, T* buf) {
+			for (std::size_t jr = 0; jr < nc; jr += NR) {
+				const std::size_t nr = std::min(NR, nc - jr);
+				const T* src = b + static_cast<std::ptrdiff_t>(jr) * csb;
+				if (rsb == 1 && csb != 1) { // transposed operand: walk down each column of B contiguously instead
+					for (std::size_t j = 0; j != nr; ++j) {
+						const T* col = src + static_cast<std::ptrdiff_t>(j) * csb;
+						for (std::size_t p = 0; p != kc; ++p) buf[p * NR + j] = col[p];
+					}
+					for (std::size_t j = nr; j != NR; ++j) {
+						for (std::size_t p = 0; p != kc; ++p) buf[p * NR + j] = T{};
+					}
+					buf += kc * NR;
+					continue;
+				}
+				for (std::size_t p = 0; p != kc; ++p) {
+					const T* row = src + static_cast<std::ptrdiff_t>(p) * rsb;
+					std::size_t j = 0;
+					if (csb == 1) {
+						for (; j != nr; ++j) buf[j] = row[j];
+					}
+					else {
+						for (; j != nr; ++j) buf[j] = row[static_cast<std::ptrdiff_t>(j) * csb];
+					}
+					for (; j != NR; ++j) buf[j] = T{};
+					buf += NR;
+				}
+			}
+		}
+
+		// C[mr x nr] = alpha * (a_sliver * b_sliver) + beta * C; beta == 0 never reads C (it may be garbage)
+		template <typename T, std::size_t MR, std::size_t NR>
+		inline void micro_kernel(std::size_t kc, T alpha, const T* a, const T* b, T beta, T* c, std::ptrdiff_t rsc, std::ptrdiff_t csc, std::size_t mr, std::size_t nr) {
+			T acc[MR][NR] = {};
+			for (std::size_t p = 0; p != kc; ++p) {
+				for (std::size_t i = 0; i != MR; ++i) {
+					const T ai = a[i];
+					for (std::size_t j = 0; j != NR; ++j) {
+						acc[i][j] += ai * b[j];
+					}
+				}
+				a += MR;
+				b += NR;
+			}
+
+			for (std::size_t i = 0; i != mr; ++i) {
+				T* row = c + static_cast<std::ptrdiff_t>(i) * rsc;
+				if (beta == T{}) {
+					for (std::size_t j = 0; j != nr; ++j) row[static_cast<std::ptrdiff_t>(j) * csc] = alpha * acc[i][j];
+				}
+				else {
+					for (std::size_t j = 0; j != nr; ++j) {
+						T& x = row[static_cast<std::ptrdiff_t>(j) * csc];
+						x = alpha * acc[i][j] + beta * x;
+					}
+				}
+			}
+		}
+
+		// one packed MC x KC block of A against one packed KC x NC panel of B
+		template <typename T>
+		inline void macro_kernel(std::size_t mc, std::size_t nc, std::size_t kc, T alpha, const T* pa, const T* pb, T beta, T* c, std::ptrdiff_t rsc, std::ptrdiff_t csc) {
+			constexpr std::size_t MR = blocking<T>::MR, NR = blocking<T>::NR;
+			for (std::size_t jr = 0; jr < nc; jr += NR) {
+				const std::size_t nr = std::min(NR, nc - jr);
+				for (std::size_t ir = 0; ir < mc; ir += MR) {
+					const std::size_t mr = std::min(MR, mc - ir);
+					micro_kernel<T, MR, NR>(kc, alpha, pa + ir * kc, pb + jr * kc, beta,
+						c + static_cast<std::ptrdiff_t>(ir) * rsc + static_cast<std::ptrdiff_t>(jr) * csc, rsc, csc, mr, nr);
+				}
+			}
+		}
+
+		// C[m x n] = alpha * A[m x k] * B[k x n] + beta * C
+		template <typename T>
+		void gemm(std::size_t m, std::size_t n, std::size_t k,
+			T alpha, const T* a, std::ptrdiff_t rsa, std::ptrdiff_t csa,
+			         const T* b, std::ptrdiff_t rsb, std::ptrdiff_t csb,
+			T beta,        T* c, std::ptrdiff_t rsc, std::ptrdiff_t csc) {
+			using blk = blocking<T>;
+			if (m == 0 || n == 0) return;
+			if (k == 0) {
+				for (std::size_t i = 0; i != m; ++i) for (std::size_t j = 0; j != n; ++j) {
+					T& x = c[static_cast<std::ptrdiff_t>(i) * rsc + static_cast<std::ptrdiff_t>(j) * csc];
+					x = (beta == T{}) ? T{} : beta * x;
+				}
+				return;
+			}
+
+			const std::size_t mc_max = std::min(blk::MC, (m + blk::MR - 1) / blk::MR * blk::MR);
+			const std::size_t nc_max = std::min(blk::NC, (n + blk::NR - 1) / blk::NR * blk::NR);
+			const std::size_t kc_max = std::min(blk::KC, k);
+			T* const pa = scratch<T>(mc_max * kc_max + kc_max * nc_max);
+			T* const pb = pa + mc_max * kc_max;
+
+			for (std::size_t jc = 0; jc < n; jc += blk::NC) {
+				const std::size_t nc = std::min(blk::NC, n - jc);
+				for (std::size_t pc = 0; pc < k; pc += blk::KC) {
+					const std::size_t kc = std::min(blk::KC, k - pc);
+					const T beta_pc = pc ? T(1) : beta; // only the first depth block scales C, the rest accumulate
+					pack_b<T, blk::NR>(kc, nc, b + static_cast<std::ptrdiff_t>(pc) * rsb + static_cast<std::ptrdiff_t>(jc) * csb, rsb, csb, pb);
+					for (std::size_t ic = 0; ic < m; ic += blk::MC) {
+						const std::size_t mc = std::min(blk::MC, m - ic);
+						pack_a<T, blk::MR>(mc, kc, a + static_cast<std::ptrdiff_t>(ic) * rsa + static_cast<std::ptrdiff_t>(pc) * csa, rsa, csa, pa);
+						macro_kernel<T>(mc, nc, kc, alpha, pa, pb, beta_pc,
+							c + static_cast<std::ptrdiff_t>(ic) * rsc + static_cast<std::ptrdiff_t>(jc) * csc, rsc, csc);
+					}
+				}
+			}
+		}
+
+		/*
+		 * same contract as gemm, spread over the scheduler
+		 * C is cut into 2d tiles (MR/NR multiples, shrunk until every thread has a few to balance with) and each task runs gemm on its own tile,
+		 * packing its own panels; when C is too small to keep every thread busy the depth is split too, the extra depth chunks going into
+		 * private buffers that are summed into C afterwards (only for k of at least a KC block; shallower products split over m and n alone)
+		 */
+		template <typename T>
+		void parallel_gemm(std::size_t m, std::size_t n, std::size_t k,
+			T alpha, const T* a, std::ptrdiff_t rsa, std::ptrdiff_t csa,
+			         const T* b, std::ptrdiff_t rsb, std::ptrdiff_t csb,
+			T beta,        T* c, std::ptrdiff_t rsc, std::ptrdiff_t csc) {
+			using blk = blocking<T>;
+			sched_detail::scheduler& pool = sched_detail::scheduler::instance();
+			const std::size_t threads = pool.concurrency();
+			// the cutoff is on total work alone; a shallow k (outer-product like updates) still splits fine over the tiles of C
+			if (threads == 1 || sched_detail::inside_task() ||
+				static_cast<double>(m) * static_cast<double>(n) * static_cast<double>(k) < 32.0 * static_cast<double>(sched_detail::threshold().load(std::memory_order_relaxed))) {
+				gemm<T>(m, n, k, alpha, a, rsa, csa, b, rsb, csb, beta, c, rsc, csc);
+				return;
+			}
+
+			const auto round_up = [](std::size_t x, std::size_t r) { return (x + r - 1) / r * r; };
+			std::size_t tm = std::min(blk::MC, round_up(m, blk::MR));
+			std::size_t tn = std::min(round_up(512, blk::NR), round_up(n, blk::NR));
+			for (;;) {
+				if (((m + tm - 1) / tm) * ((n + tn - 1) / tn) >= 4 * threads) break;
+				const bool shrink_n = tn > 4 * blk::NR, shrink_m = tm > 4 * blk::MR;
+				if (shrink_n && (tn >= tm || !shrink_m)) tn = round_up(tn / 2, blk::NR);
+				else if (shrink_m) tm = round_up(tm / 2, blk::MR);
+				else break;
+			}
+			const std::size_t mt = (m + tm - 1) / tm, nt = (n + tn - 1) / tn, tiles = mt * nt;
+
+			// depth chunks are whole KC blocks
+			std::size_t splits = tiles < threads ? std::min((threads + tiles - 1) / tiles, k / blk::KC) : 1;
+			if (splits == 0) splits = 1;
+			const std::size_t kchunk = round_up((k + splits - 1) / splits, blk::KC);
+			splits = (k + kchunk - 1) / kchunk;
+			std::unique_ptr<aligned_buffer<T>> partial(splits > 1 ? new aligned_buffer<T>((splits - 1) * m * n) : nullptr);
+
+			pool.parallel_for(tiles * splits, [&](std::size_t t) {
+				const std::size_t s = t / tiles, i0 = (t % tiles) / nt * tm, j0 = (t % tiles) % nt * tn;
+				const std::size_t mi = std::min(tm, m - i0), nj = std::min(tn, n - j0), p0 = s * kchunk, kp = std::min(kchunk, k - p0);
+				const T* ap = a + static_cast<std::ptrdiff_t>(i0) * rsa + static_cast<std::ptrdiff_t>(p0) * csa;
+				const T* bp = b + static_cast<std::ptrdiff_t>(p0) * rsb + static_cast<std::ptrdiff_t>(j0) * csb;
+				if (s == 0) {
+					gemm<T>(mi, nj, kp, alpha, ap, rsa, csa, bp, rsb, csb, beta, c + static_cast<std::ptrdiff_t>(i0) * rsc + static_cast<std::ptrdiff_t>(j0) * csc, rsc, csc);
+				}
+				else {
+					gemm<T>(mi, nj, kp, alpha, ap, rsa, csa, bp, rsb, csb, T(0), partial->data() + (s - 1) * m * n + i0 * n + j0, static_cast<std::ptrdiff_t>(n), 1);
+				}
+			});
+			if (splits > 1) {
+				pool.parallel_for(m, [&](std::size_t i) {
+					T* row = c + static_cast<std::ptrdiff_t>(i) * rsc;
+					for (std::size_t s = 1; s != splits; ++s) {
+						const T* p = partial->data() + (s - 1) * m * n + i * n;
+						for (std::size_t j = 0; j != n; ++j) row[static_cast<std::ptrdiff_t>(j) * csc] += p[j];
+					}
+				});
+			}
+		}
+	}
+	}
+
+	inline namespace detail {
+	namespace simd_detail {
+		/*
+		 * elementwise kernels (zip with +/-, scale by a scalar) for float, double and 32/64 bit integers
+		 * the widest instruction set the cpu supports is picked once at startup and the kernels are reached through a function table,
+		 * so the header never has to be compiled with -mavx2 / /arch:AVX2 to make use of it
+		 * large non-aliasing outputs use non-temporal stores since these ops are purely bandwidth bound and the result is not re-read soon
+		 */
+
+		enum class isa_t : std::uint8_t { scalar, sse2, avx2, avx512 };
+		enum class elementwise_op : std::uint8_t { add, sub, mul };
+
+		// outputs at least this big (in bytes) bypass the cache; roughly where the output stops fitting in L2 of anything recent
+#	ifndef BHAVESH_MATRIX_STREAMING_THRESHOLD
+#	define BHAVESH_MATRIX_STREAMING_THRESHOLD (std::size_t(1) << 21)
+#	endif
+
+		inline isa_t detect_isa() noexcept {
+#	if BHAVESH_MATRIX_X86_SIMD
+#	  if defined(_MSC_VER) && !defined(__clang__)
+			int r[4];
+			__cpuidex(r, 0, 0);
+			const int max_leaf = r[0];
+			__cpuidex(r, 1, 0);
+			const bool osxsave = (r[2] & (1 << 27)) != 0, avx = (r[2] & (1 << 28)) != 0;
+			const unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+			if (max_leaf < 7 || !avx || (xcr0 & 0x6) != 0x6) return isa_t::sse2;
+			__cpuidex(r, 7, 0);
+			if ((r[1] & (1 << 16)) && (xcr0 & 0xE6) == 0xE6) return isa_t::avx512;
+			if (r[1] & (1 << 5)) return isa_t::avx2;
+			return isa_t::sse2;
+#	  else
+			__builtin_cpu_init(); // also checks that the os saves the wider registers
+			if (__builtin_cpu_supports("avx512f")) return isa_t::avx512;
+			if (__builtin_cpu_supports("avx2")) return isa_t::avx2;
+			return isa_t::sse2;
+#	  endif
+#	else
+			return isa_t::scalar;
+#	endif
+		}
+
+		// probed once, on first use
+		inline isa_t active_isa() noexcept {
+			static const isa_t isa = detect_isa();
+			return isa;
+		}
+
+		// the integer kernels are sign agnostic (two's complement wrap-around), so unsigned types share the vector
+		// ops of their signed twins; only the vector registers are reinterpreted, scalar heads and tails stay in T where unsigned
+		// wrap-around is defined
+		template <typename T, bool = std::is_integral<T>::value && !std::is_same<T, bool>::value>
+		struct kernel_type { using type = T; };
+		template <typename T>
+		struct kernel_type<T, true> { using type = std::make_signed_t<T>; };
+		template <typename T>
+		using kernel_type_of = typename kernel_type<T>::type;
+
+		template <elementwise_op op, typename T>
+		inline T scalar_apply(const T& a, const T& b) {
+			if BHAVESH_CXX17_CONSTEXPR(op == elementwise_op::add) return a + b;
+			else if BHAVESH_CXX17_CONSTEXPR(op == elementwise_op::sub) return a - b;
+			else return a * b;
+		}
+
+		template <elementwise_op op, typename T>
+		void scalar_zip(const T* a, const T* b, T* out, std::size_t s) {
+			for (std::size_t i = 0; i != s; ++i) out[i] = scalar_apply<op>(a[i], b[i]);
+		}
+
+		template <elementwise_op op, typename T>
+		void scalar_broadcast(const T* a, T b, T* out, std::size_t s) {
+			for (std::size_t i = 0; i != s; ++i) out[i] = scalar_apply<op>(a[i], b);
+		}
+
+#	if BHAVESH_MATRIX_X86_SIMD
+#	  if defined(_MSC_VER) && !defined(__clang__)
+#	    define BHAVESH_TARGET_AVX2
+#	    define BHAVESH_TARGET_AVX512
+#	  else
+#	    define BHAVESH_TARGET_AVX2 __attribute__((target("avx2")))
+#	    define BHAVESH_TARGET_AVX512 __attribute__((target("avx512f")))
+#	  endif
+
+		/* one ops table per (isa, type); has_mul is false where the isa has no lane-wise multiply for the type */
+		template <typename T> struct sse2_ops;
+		template <typename T> struct avx2_ops;
+		template <typename T> struct avx512_ops;
+
+#	  define BHAVESH_SIMD_OPS(name, target, T, vec, w, mul_ok, ld, st, stm, set1, add_, sub_, mul_) \
+		template <> struct name<T> { \
+			using type = vec; \
+			static constexpr std::size_t width = w; \
+			static constexpr bool has_mul = mul_ok; \
+			static target vec load(const T* p) { return ld; } \
+			static target void store(T* p, vec v) { st; } \
+			static target void stream(T* p, vec v) { stm; } \
+			static target vec broadcast(T x) { return set1; } \
+			template <elementwise_op op> static target vec apply(vec a, vec b) { \
+				if BHAVESH_CXX17_CONSTEXPR(op == elementwise_op::add) return add_; \
+				else if BHAVESH_CXX17_CONSTEXPR(op == elementwise_op::sub) return sub_; \
+				else return mul_; \
+			} \
+		};
+
+		BHAVESH_SIMD_OPS(sse2_ops, , float, __m128, 4, true, _mm_loadu_ps(p), _mm_store_ps(p, v), _mm_stream_ps(p, v), _mm_set1_ps(x), _mm_add_ps(a, b), _mm_sub_ps(a, b), _mm_mul_ps(a, b))
+		BHAVESH_SIMD_OPS(sse2_ops, , double, __m128d, 2, true, _mm_loadu_pd(p), _mm_store_pd(p, v), _mm_stream_pd(p, v), _mm_set1_pd(x), _mm_add_pd(a, b), _mm_sub_pd(a, b), _mm_mul_pd(a, b))
+		BHAVESH_SIMD_OPS(sse2_ops, , std::int32_t, __m128i, 4, false,
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), _mm_store_si128(reinterpret_cast<__m128i*>(p), v), _mm_stream_si128(reinterpret_cast<__m128i*>(p), v),
+			_mm_set1_epi32(x), _mm_add_epi32(a, b), _mm_sub_epi32(a, b), a)
+		BHAVESH_SIMD_OPS(sse2_ops, , std::int64_t, __m128i, 2, false,
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), _mm_store_si128(reinterpret_cast<__m128i*>(p), v), _mm_stream_si128(reinterpret_cast<__m128i*>(p), v),
+			_mm_set1_epi64x(x), _mm_add_epi64(a, b), _mm_sub_epi64(a, b), a)
+
+		BHAVESH_SIMD_OPS(avx2_ops, BHAVESH_TARGET_AVX2, float, __m256, 8, true, _mm256_loadu_ps(p), _mm256_store_ps(p, v), _mm256_stream_ps(p, v), _mm256_set1_ps(x), _mm256_add_ps(a, b), _mm256_sub_ps(a, b), _mm256_mul_ps(a, b))
+		BHAVESH_SIMD_OPS(avx2_ops, BHAVESH_TARGET_AVX2, double, __m256d, 4, true, _mm256_loadu_pd(p), _mm256_store_pd(p, v), _mm256_stream_pd(p, v), _mm256_set1_pd(x), _mm256_add_pd(a, b), _mm256_sub_pd(a, b), _mm256_mul_pd(a, b))
+		BHAVESH_SIMD_OPS(avx2_ops, BHAVESH_TARGET_AVX2, std::int32_t, __m256i, 8, true,
+			_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)), _mm256_store_si256(reinterpret_cast<__m256i*>(p), v), _mm256_stream_si256(reinterpret_cast<__m256i*>(p), v),
+			_mm256_set1_epi32(x), _mm256_add_epi32(a, b), _mm256_sub_epi32(a, b), _mm256_mullo_epi32(a, b))
+		BHAVESH_SIMD_OPS(avx2_ops, BHAVESH_TARGET_AVX2, std::int64_t, __m256i, 4, false,
+			_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)), _mm256_store_si256(reinterpret_cast<__m256i*>(p), v), _mm256_stream_si256(reinterpret_cast<__m256i*>(p), v),
+			_mm256_set1_epi64x(x), _mm256_add_epi64(a, b), _mm256_sub_epi64(a, b), a)
+
+		BHAVESH_SIMD_OPS(avx512_ops, BHAVESH_TARGET_AVX512, float, __m512, 16, true, _mm512_loadu_ps(p), _mm512_store_ps(p, v), _mm512_stream_ps(p, v), _mm512_set1_ps(x), _mm512_add_ps(a, b), _mm512_sub_ps(a, b), _mm512_mul_ps(a, b))
+		BHAVESH_SIMD_OPS(avx512_ops, BHAVESH_TARGET_AVX512, double, __m512d, 8, true, _mm512_loadu_pd(p), _mm512_store_pd(p, v), _mm512_stream_pd(p, v), _mm512_set1_pd(x), _mm512_add_pd(a, b), _mm512_sub_pd(a, b), _mm512_mul_pd(a, b))
+		BHAVESH_SIMD_OPS(avx512_ops, BHAVESH_TARGET_AVX512, std::int32_t, __m512i, 16, true,
+			_mm512_loadu_si512(p), _mm512_store_si512(p, v), _mm512_stream_si512(reinterpret_cast<__m512i*>(p), v),
+			_mm512_set1_epi32(x), _mm512_add_epi32(a, b), _mm512_sub_epi32(a, b), _mm512_mullo_epi32(a, b))
+		BHAVESH_SIMD_OPS(avx512_ops, BHAVESH_TARGET_AVX512, std::int64_t, __m512i, 8, false, // 64 bit mullo needs avx512dq
+			_mm512_loadu_si512(p), _mm512_store_si512(p, v), _mm512_stream_si512(reinterpret_cast<__m512i*>(p), v),
+			_mm512_set1_epi64(x), _mm512_add_epi64(a, b), _mm512_sub_epi64(a, b), a)
+
+#	  undef BHAVESH_SIMD_OPS
+
+		/*
+		 * shared loop shape: scalar head until `out` is vector aligned, aligned (or streaming) vector body, scalar tail
+		 * the rhs is either a second array (zip) or one broadcast value (broadcast); loads stay unaligned since the inputs need not share out's alignment
+		 */
+#	  define BHAVESH_SIMD_KERNELS(isa, target) \
+		template <elementwise_op op, typename T> \
+		target void isa##_zip(const T* a, const T* b, T* out, std::size_t s) { \
+			using K = kernel_type_of<T>; \
+			using ops = isa##_ops<K>; \
+			const K* const ka = reinterpret_cast<const K*>(a); \
+			const K* const kb = reinterpret_cast<const K*>(b); \
+			K* const kout = reinterpret_cast<K*>(out); \
+			if BHAVESH_CXX17_CONSTEXPR(op == elementwise_op::mul && !ops::has_mul) { scalar_zip<op>(a, b, out, s); return; } \
+			else { \
+				constexpr std::size_t w = ops::width; \
+				std::size_t i = 0; \
+				for (; i != s && reinterpret_cast<std::uintptr_t>(out + i) % (w * sizeof(T)) != 0; ++i) out[i] = scalar_apply<op>(a[i], b[i]); \
+				const bool streaming = s * sizeof(T) >= BHAVESH_MATRIX_STREAMING_THRESHOLD && out != a && out != b; \
+				if (streaming) { \
+					for (; i + w <= s; i += w) ops::stream(kout + i, ops::template apply<op>(ops::load(ka + i), ops::load(kb + i))); \
+					_mm_sfence(); \
+				} \
+				else { \
+					for (; i + 2 * w <= s; i += 2 * w) { \
+						const auto x0 = ops::template apply<op>(ops::load(ka + i), ops::load(kb + i)); \
+						const auto x1 = ops::template apply<op>(ops::load(ka + i + w), ops::load(kb + i + w)); \
+						ops::store(kout + i, x0); \
+						ops::store(kout + i + w, x1); \
+					} \
+					for (; i + w <= s; i += w) ops::store(kout + i, ops::template apply<op>(ops::load(ka + i), ops::load(kb + i))); \
+				} \
+				for (; i != s; ++i) out[i] = scalar_apply<op>(a[i], b[i]); \
+			} \
+		} \
+		template <elementwise_op op, typename T> \
+		target void isa##_broadcast(const T* a, T b, T* out, std::size_t s) { \
+			using K = kernel_type_of<T>; \
+			using ops = isa##_ops<K>; \
+			const K* const ka = reinterpret_cast<const K*>(a); \
+			K* const kout = reinterpret_cast<K*>(out); \
+			if BHAVESH_CXX17_CONSTEXPR(op == elementwise_op::mul && !ops::has_mul) { scalar_broadcast<op>(a, b, out, s); return; } \
+			else { \
+				constexpr std::size_t w = ops::width; \
+				const auto vb = ops::broadcast(static_cast<K>(b)); \
+				std::size_t i = 0; \
+				for (; i != s && reinterpret_cast<std::uintptr_t>(out + i) % (w * sizeof(T)) != 0; ++i) out[i] = scalar_apply<op>(a[i], b); \
+				const bool streaming = s * sizeof(T) >= BHAVESH_MATRIX_STREAMING_THRESHOLD && out != a; \
+				if (streaming) { \
+					for (; i + w <= s; i += w) ops::stream(kout + i, ops::template apply<op>(ops::load(ka + i), vb)); \
+					_mm_sfence(); \
+				} \
+				else { \
+					for (; i + 2 * w <= s; i += 2 * w) { \
+						const auto x0 = ops::template apply<op>(ops::load(ka + i), vb); \
+						const auto x1 = ops::template apply<op>(ops::load(ka + i + w), vb); \
+						ops::store(kout + i, x0); \
+						ops::store(kout + i + w, x1); \
+					} \
+					for (; i + w <= s; i += w) ops::store(kout + i, ops::template apply<op>(ops::load(ka + i), vb)); \
+				} \
+				for (; i != s; ++i) out[i] = scalar_apply<op>(a[i], b); \
+			} \
+		}
+
+		BHAVESH_SIMD_KERNELS(sse2, )
+		BHAVESH_SIMD_KERNELS(avx2, BHAVESH_TARGET_AVX2)
+		BHAVESH_SIMD_KERNELS(avx512, BHAVESH_TARGET_AVX512)
+
+#	  undef BHAVESH_SIMD_KERNELS
+#	endif // BHAVESH_MATRIX_X86_SIMD
+
+		template <typename T>
+		struct has_kernels : std::integral_constant<bool,
+			std::is_same<T, float>::value || std::is_same<T, double>::value ||
+			std::is_same<kernel_type_of<T>, std::int32_t>::value || std::is_same<kernel_type_of<T>, std::int64_t>::value> {};
+
+		template <typename T>
+		struct kernel_table {
+			void (*zip[3])(const T*, const T*, T*, std::size_t);
+			void (*broadcast[3])(const T*, T, T*, std::size_t);
+		};
+
+		/*
+		 * the dispatch pattern the other kernel families follow (gemv_detail here, reduce_detail and map_detail in their headers):
+		 * each loop is stamped out once per isa under that isa's target attribute, and one table per instantiation is filled from
+		 * active_isa() on first use. families written as plain loops for the compiler to vectorize have no sse2 build: sse2 is the
+		 * baseline the compiler already targets, so their scalar build covers it
+		 */
+		template <typename T>
+		inline kernel_table<T> make_kernel_table(isa_t isa) {
+			using op = elementwise_op;
+			switch (isa) {
+#	if BHAVESH_MATRIX_X86_SIMD
+			case isa_t::avx512: return { { avx512_zip<op::add, T>, avx512_zip<op::sub, T>, avx512_zip<op::mul, T> }, { avx512_broadcast<op::add, T>, avx512_broadcast<op::sub, T>, avx512_broadcast<op::mul, T> } };
+			case isa_t::avx2:   return { { avx2_zip  <op::add, T>, avx2_zip  <op::sub, T>, avx2_zip  <op::mul, T> }, { avx2_broadcast  <op::add, T>, avx2_broadcast  <op::sub, T>, avx2_broadcast  <op::mul, T> } };
+			case isa_t::sse2:   return { { sse2_zip  <op::add, T>, sse2_zip  <op::sub, T>, sse2_zip  <op::mul, T> }, { sse2_broadcast  <op::add, T>, sse2_broadcast  <op::sub, T>, sse2_broadcast  <op::mul, T> } };
+#	endif
+			default:            return { { scalar_zip<op::add, T>, scalar_zip<op::sub, T>, scalar_zip<op::mul, T> }, { scalar_broadcast<op::add, T>, scalar_broadcast<op::sub, T>, scalar_broadcast<op::mul, T> } };
+			}
+		}
+
+		template <typename T>
+		inline const kernel_table<T>& kernels() {
+			static const kernel_table<T> table = make_kernel_table<T>(active_isa());
+			return table;
+		}
+
+		/* entry points used by matrix; anything trivially copyable without a kernel gets a plain loop over raw storage the compiler can vectorize */
+		/* large inputs are cut into ranges for the scheduler; out may alias a or b exactly, since every range reads before it writes its own elements */
+		template <elementwise_op op, typename T>
+		inline void zip(const T* a, const T* b, T* out, std::size_t s) {
+			sched_detail::for_ranges<T>(s, [a, b, out](std::size_t first, std::size_t last) {
+				if BHAVESH_CXX17_CONSTEXPR(has_kernels<T>::value) {
+					kernels<T>().zip[static_cast<int>(op)](a + first, b + first, out + first, last - first);
+				}
+				else {
+					for (std::size_t i = first; i != last; ++i) (matrix_detail::construct_at)(out + i, scalar_apply<op>(a[i], b[i]));
+				}
+			});
+		}
+
+		template <elementwise_op op, typename T>
+		inline void broadcast(const T* a, const T& b, T* out, std::size_t s) {
+			sched_detail::for_ranges<T>(s, [a, &b, out](std::size_t first, std::size_t last) {
+				if BHAVESH_CXX17_CONSTEXPR(has_kernels<T>::value) {
+					kernels<T>().broadcast[static_cast<int>(op)](a + first, b, out + first, last - first);
+				}
+				else {
+					for (std::size_t i = first; i != last; ++i) (matrix_detail::construct_at)(out + i, scalar_apply<op>(a[i], b));
+				}
+			});
+		}
+
+		// when matrix routes elementwise work through here instead of element-at-a-time construction
+		template <typename T, typename By, typename To>
+		struct use_kernels : std::integral_constant<bool,
+			std::is_trivially_copyable<T>::value && std::is_same<T, By>::value && std::is_same<T, To>::value> {};
+	}
+	}
+
+	inline namespace detail {
+	namespace gemv_detail {
+		/*
+		 * y = alpha * A x + beta * y; a matrix-vector product does two flops per element of A and touches each one once, so it is bound
+		 * by how fast A streams in and the kernels are built around reading A exactly once while x (or y) stays in cache:
+		 * - rows of A contiguous: dot products of four rows at a time against the same stretch of x
+		 * - columns of A contiguous (a transposed operand, or A^T x): four rows of A^T scaled and summed into y at a time
+		 * float and double go through the simd_detail ops of the isa picked at startup, other arithmetic types through plain loops
+		 */
+
+		// y[r] = a_r . x for the rows r < rows (row stride lda) of a
+		template <typename T>
+		void scalar_dot_rows(const T* a, std::size_t lda, std::size_t rows, const T* x, std::size_t k, T* y) {
+			std::size_t r = 0;
+			for (; r + 4 <= rows; r += 4) {
+				const T* a0 = a + r * lda; const T* a1 = a0 + lda; const T* a2 = a1 + lda; const T* a3 = a2 + lda;
+				T s0{}, s1{}, s2{}, s3{};
+				for (std::size_t j = 0; j != k; ++j) {
+					s0 = static_cast<T>(s0 + a0[j] * x[j]);
+					s1 = static_cast<T>(s1 + a1[j] * x[j]);
+					s2 = static_cast<T>(s2 + a2[j] * x[j]);
+					s3 = static_cast<T>(s3 + a3[j] * x[j]);
+				}
+				y[r] = s0; y[r + 1] = s1; y[r + 2] = s2; y[r + 3] = s3;
+			}
+			for (; r != rows; ++r) {
+				const T* ar = a + r * lda;
+				T s{};
+				for (std::size_t j = 0; j != k; ++j) s = static_cast<T>(s + ar[j] * x[j]);
+				y[r] = s;
+			}
+		}
+
+		// y[j] += x[0] * a_0[j] + ... + x[rows - 1] * a_(rows - 1)[j] for j < n
+		template <typename T>
+		void scalar_axpy_rows(const T* a, std::size_t lda, std::size_t rows, const T* x, T* y, std::size_t n) {
+			std::size_t r = 0;
+			for (; r + 4 <= rows; r += 4) {
+				const T* a0 = a + r * lda; const T* a1 = a0 + lda; const T* a2 = a1 + lda; const T* a3 = a2 + lda;
+				const T x0 = x[r], x1 = x[r + 1], x2 = x[r + 2], x3 = x[r + 3];
+				for (std::size_t j = 0; j != n; ++j) y[j] = static_cast<T>(y[j] + x0 * a0[j] + x1 * a1[j] + x2 * a2[j] + x3 * a3[j]);
+			}
+			for (; r != rows; ++r) {
+				const T* ar = a + r * lda;
+				const T xr = x[r];
+				for (std::size_t j = 0; j != n; ++j) y[j] = static_cast<T>(y[j] + xr * ar[j]);
+			}
+		}
+
+#	if BHAVESH_MATRIX_X86_SIMD
+		/* the same loop shapes on simd_detail's ops; each dot product keeps its own accumulator and reduces it once at the end */
+#	  define BHAVESH_GEMV_KERNELS(isa, target) \
+		template <typename T> \
+		target T isa##_reduce(typename simd_detail::isa##_ops<T>::type v) { \
+			using ops = simd_detail::isa##_ops<T>; \
+			alignas(64) T lanes[ops::width]; \
+			ops::store(lanes, v); \
+			T s = 0; \
+			for (std::size_t l = 0; l != ops::width; ++l) s += lanes[l]; \
+			return s; \
+		} \
+		template <typename T> \
+		target void isa##_dot_rows(const T* a, std::size_t lda, std::size_t rows, const T* x, std::size_t k, T* y) { \
+			using ops = simd_detail::isa##_ops<T>; \
+			constexpr auto add = simd_detail::elementwise_op::add; \
+			constexpr auto mul = simd_detail::elementwise_op::mul; \
+			constexpr std::size_t w = ops::width; \
+			std::size_t r = 0; \
+			for (; r + 4 <= rows; r += 4) { \
+				const T* a0 = a + r * lda; const T* a1 = a0 + lda; const T* a2 = a1 + lda; const T* a3 = a2 + lda; \
+				auto s0 = ops::broadcast(T(0)), s1 = s0, s2 = s0, s3 = s0; \
+				std::size_t j = 0; \
+				for (; j + w <= k; j += w) { \
+					const auto xj = ops::load(x + j); \
+					s0 = ops::template apply<add>(s0, ops::template apply<mul>(ops::load(a0 + j), xj)); \
+					s1 = ops::template apply<add>(s1, ops::template apply<mul>(ops::load(a1 + j), xj)); \
+					s2 = ops::template apply<add>(s2, ops::template apply<mul>(ops::load(a2 + j), xj)); \
+					s3 = ops::template apply<add>(s3, ops::template apply<mul>(ops::load(a3 + j), xj)); \
+				} \
+				T t0 = isa##_reduce<T>(s0), t1 = isa##_reduce<T>(s1), t2 = isa##_reduce<T>(s2), t3 = isa##_reduce<T>(s3); \
+				for (; j != k; ++j) { \
+					t0 += a0[j] * x[j]; t1 += a1[j] * x[j]; t2 += a2[j] * x[j]; t3 += a3[j] * x[j]; \
+				} \
+				y[r] = t0; y[r + 1] = t1; y[r + 2] = t2; y[r + 3] = t3; \
+			} \
+			for (; r != rows; ++r) { \
+				const T* ar = a + r * lda; \
+				auto s0 = ops::broadcast(T(0)), s1 = s0; \
+				std::size_t j = 0; \
+				for (; j + 2 * w <= k; j += 2 * w) { \
+					s0 = ops::template apply<add>(s0, ops::template apply<mul>(ops::load(ar + j), ops::load(x + j))); \
+					s1 = ops::template apply<add>(s1, ops::template apply<mul>(ops::load(ar + j + w), ops::load(x + j + w))); \
+				} \
+				for (; j + w <= k; j += w) s0 = ops::template apply<add>(s0, ops::template apply<mul>(ops::load(ar + j), ops::load(x + j))); \
+				T t = isa##_reduce<T>(ops::template apply<add>(s0, s1)); \
+				for (; j != k; ++j) t += ar[j] * x[j]; \
+				y[r] = t; \
+			} \
+		} \
+		template <typename T> \
+		target void isa##_axpy_rows(const T* a, std::size_t lda, std::size_t rows, const T* x, T* y, std::size_t n) { \
+			using ops = simd_detail::isa##_ops<T>; \
+			constexpr auto add = simd_detail::elementwise_op::add; \
+			constexpr auto mul = simd_detail::elementwise_op::mul; \
+			constexpr std::size_t w = ops::width; \
+			std::size_t head = 0; \
+			while (head != n && reinterpret_cast<std::uintptr_t>(y + head) % (w * sizeof(T)) != 0) ++head; \
+			std::size_t r = 0; \
+			for (; r + 4 <= rows; r += 4) { \
+				const T* a0 = a + r * lda; const T* a1 = a0 + lda; const T* a2 = a1 + lda; const T* a3 = a2 + lda; \
+				const T x0 = x[r], x1 = x[r + 1], x2 = x[r + 2], x3 = x[r + 3]; \
+				const auto v0 = ops::broadcast(x0), v1 = ops::broadcast(x1), v2 = ops::broadcast(x2), v3 = ops::broadcast(x3); \
+				std::size_t j = 0; \
+				for (; j != head; ++j) y[j] += x0 * a0[j] + x1 * a1[j] + x2 * a2[j] + x3 * a3[j]; \
+				for (; j + w <= n; j += w) { \
+					const auto s01 = ops::template apply<add>(ops::template apply<mul>(v0, ops::load(a0 + j)), ops::template apply<mul>(v1, ops::load(a1 + j))); \
+					const auto s23 = ops::template apply<add>(ops::template apply<mul>(v2, ops::load(a2 + j)), ops::template apply<mul>(v3, ops::load(a3 + j))); \
+					ops::store(y + j, ops::template apply<add>(ops::load(y + j), ops::template apply<add>(s01, s23))); \
+				} \
+				for (; j != n; ++j) y[j] += x0 * a0[j] + x1 * a1[j] + x2 * a2[j] + x3 * a3[j]; \
+			} \
+			for (; r != rows; ++r) { \
+				const T* ar = a + r * lda; \
+				const T xr = x[r]; \
+				const auto vr = ops::broadcast(xr); \
+				std::size_t j = 0; \
+				for (; j != head; ++j) y[j] += xr * ar[j]; \
+				for (; j + w <= n; j += w) ops::store(y + j, ops::template apply<add>(ops::load(y + j), ops::template apply<mul>(vr, ops::load(ar + j)))); \
+				for (; j != n; ++j) y[j] += xr * ar[j]; \
+			} \
+		}
+
+		BHAVESH_GEMV_KERNELS(sse2, )
+		BHAVESH_GEMV_KERNELS(avx2, BHAVESH_TARGET_AVX2)
+		BHAVESH_GEMV_KERNELS(avx512, BHAVESH_TARGET_AVX512)
+
+#	  undef BHAVESH_GEMV_KERNELS
+#	endif // BHAVESH_MATRIX_X86_SIMD
+
+		template <typename T>
+		struct has_kernels : std::integral_constant<bool, std::is_same<T, float>::value || std::is_same<T, double>::value> {};
+
+		template <typename T>
+		struct kernel_table {
+			void (*dot_rows)(const T*, std::size_t, std::size_t, const T*, std::size_t, T*);
+			void (*axpy_rows)(const T*, std::size_t, std::size_t, const T*, T*, std::size_t);
+		};
+
+		template <typename T>
+		inline kernel_table<T> make_kernel_table(simd_detail::isa_t isa) {
+			using simd_detail::isa_t;
+			switch (isa) {
+#	if BHAVESH_MATRIX_X86_SIMD
+			case isa_t::avx512: return { avx512_dot_rows<T>, avx512_axpy_rows<T> };
+			case isa_t::avx2:   return { avx2_dot_rows  <T>, avx2_axpy_rows  <T> };
+			case isa_t::sse2:   return { sse2_dot_rows  <T>, sse2_axpy_rows  <T> };
+#	endif
+			default:            return { scalar_dot_rows<T>, scalar_axpy_rows<T> };
+			}
+		}
+
+		template <typename T>
+		inline const kernel_table<T>& kernels() {
+			static const kernel_table<T> table = gemv_detail::make_kernel_table<T>(simd_detail::active_isa()); // qualified: isa_t would drag simd_detail's in by adl
+			return table;
+		}
+
+		template <typename T>
+		inline void dot_rows(const T* a, std::size_t lda, std::size_t rows, const T* x, std::size_t k, T* y) {
+			if BHAVESH_CXX17_CONSTEXPR(has_kernels<T>::value) kernels<T>().dot_rows(a, lda, rows, x, k, y);
+			else scalar_dot_rows(a, lda, rows, x, k, y);
+		}
+
+		template <typename T>
+		inline void axpy_rows(const T* a, std::size_t lda, std::size_t rows, const T* x, T* y, std::size_t n) {
+			if BHAVESH_CXX17_CONSTEXPR(has_kernels<T>::value) kernels<T>().axpy_rows(a, lda, rows, x, y, n);
+			else scalar_axpy_rows(a, lda, rows, x, y, n);
+		}
+
+		// x . y over contiguous storage
+		template <typename T>
+		inline T dot(std::size_t n, const T* x, const T* y) {
+			T r{};
+			dot_rows(x, 0, 1, y, n, &r);
+			return r;
+		}
+
+		// columns of y the transposed kernel keeps hot while every row of A streams past
+		constexpr std::size_t column_block = 2048;
+
+		// y = alpha * A x + beta * y for row-major A (unit column stride), contiguous x and strided y; the rows are split over the pool
+		template <typename T>
+		void gemv_rows(std::size_t m, std::size_t k, T alpha, const T* a, std::size_t lda, const T* x, T beta, T* y, std::ptrdiff_t incy) {
+			sched_detail::for_ranges<T>(m, [=](std::size_t first, std::size_t last) {
+				constexpr std::size_t chunk = 64;
+				T t[chunk];
+				for (std::size_t i = first; i < last; i += chunk) {
+					const std::size_t c = std::min(chunk, last - i);
+					dot_rows(a + i * lda, lda, c, x, k, t);
+					for (std::size_t r = 0; r != c; ++r) {
+						T& yi = y[static_cast<std::ptrdiff_t>(i + r) * incy];
+						yi = beta == T(0) ? static_cast<T>(alpha * t[r]) : static_cast<T>(alpha * t[r] + beta * yi);
+					}
+				}
+			}, k);
+		}
+
+		// y = alpha * A^T x + beta * y for row-major A (m x n), contiguous x and y
+		// wide y is cut into column slices, one pool task each; narrow y (where slices would be too thin) gets per-task partial sums over row ranges
+		template <typename T>
+		void gemv_t_rows(std::size_t m, std::size_t n, T alpha, const T* a, std::size_t lda, const T* x, T beta, T* y) {
+			if (beta == T(0)) std::fill(y, y + n, T(0));
+			else if (beta != T(1)) simd_detail::broadcast<simd_detail::elementwise_op::mul>(y, beta, y, n);
+
+			std::unique_ptr<gemm_detail::aligned_buffer<T>> scaled;
+			if (alpha != T(1)) { // fold alpha into x once instead of into every update of y
+				scaled.reset(new gemm_detail::aligned_buffer<T>(m));
+				for (std::size_t i = 0; i != m; ++i) scaled->data()[i] = static_cast<T>(alpha * x[i]);
+				x = scaled->data();
+			}
+			const auto update = [a, lda, x](std::size_t r0, std::size_t r1, std::size_t c0, std::size_t c1, T* out) {
+				for (std::size_t j = c0; j < c1; j += column_block) axpy_rows(a + r0 * lda + j, lda, r1 - r0, x + r0, out + (j - c0), std::min(column_block, c1 - j));
+			};
+
+			auto& pool = sched_detail::scheduler::instance();
+			if (!sched_detail::worth_splitting(m * n)) {
+				update(0, m, 0, n, y);
+				return;
+			}
+			const std::size_t parts = pool.concurrency();
+			if (n >= parts * (4096 / sizeof(T))) { // at least 4 KiB of y per thread
+				sched_detail::for_ranges<T>(n, [&update, m, y](std::size_t first, std::size_t last) { update(0, m, first, last, y + first); }, m);
+				return;
+			}
+			gemm_detail::aligned_buffer<T> partial(parts * n);
+			pool.parallel_for(parts, [&update, &partial, m, n, parts](std::size_t p) {
+				T* out = partial.data() + p * n;
+				std::fill(out, out + n, T(0));
+				update(m * p / parts, m * (p + 1) / parts, 0, n, out);
+			});
+			for (std::size_t p = 0; p != parts; ++p) {
+				const T* part = partial.data() + p * n;
+				for (std::size_t j = 0; j != n; ++j) y[j] = static_cast<T>(y[j] + part[j]);
+			}
+		}
+
+		// y = alpha * A x + beta * y for an m x k A with strides (rsa, csa) and strided x and y; beta == 0 never reads y
+		// x (and y, when the transposed kernel needs it contiguous) are packed first, which is O(m + k) next to the O(m k) product
+		template <typename T>
+		void gemv(std::size_t m, std::size_t k, T alpha, const T* a, std::ptrdiff_t rsa, std::ptrdiff_t csa, const T* x, std::ptrdiff_t incx,
+			T beta, T* y, std::ptrdiff_t incy) {
+			if (m == 0) return;
+			if (k == 0) {
+				for (std::size_t i = 0; i != m; ++i) {
+					T& yi = y[static_cast<std::ptrdiff_t>(i) * incy];
+					yi = beta == T(0) ? T(0) : static_cast<T>(beta * yi);
+				}
+				return;
+			}
+			std::unique_ptr<gemm_detail::aligned_buffer<T>> packed;
+			if (incx != 1) {
+				packed.reset(new gemm_detail::aligned_buffer<T>(k));
+				for (std::size_t p = 0; p != k; ++p) packed->data()[p] = x[static_cast<std::ptrdiff_t>(p) * incx];
+				x = packed->data();
+			}
+
+			if (csa == 1 && rsa >= 0) {
+				gemv_rows(m, k, alpha, a, static_cast<std::size_t>(rsa), x, beta, y, incy);
+				return;
+			}
+			if (rsa == 1 && csa >= 0) { // the columns of A are the rows of A^T
+				if (incy == 1) {
+					gemv_t_rows(k, m, alpha, a, static_cast<std::size_t>(csa), x, beta, y);
+					return;
+				}
+				gemm_detail::aligned_buffer<T> yc(m);
+				if (beta != T(0)) {
+					for (std::size_t i = 0; i != m; ++i) yc.data()[i] = y[static_cast<std::ptrdiff_t>(i) * incy];
+				}
+				gemv_t_rows(k, m, alpha, a, static_cast<std::size_t>(csa), x, beta, yc.data());
+				for (std::size_t i = 0; i != m; ++i) y[static_cast<std::ptrdiff_t>(i) * incy] = yc.data()[i];
+				return;
+			}
+			// neither stride is unit: one strided dot product per row
+			sched_detail::for_ranges<T>(m, [=](std::size_t first, std::size_t last) {
+				for (std::size_t i = first; i != last; ++i) {
+					const T* ai = a + static_cast<std::ptrdiff_t>(i) * rsa;
+					T s{};
+					for (std::size_t p = 0; p != k; ++p) s = static_cast<T>(s + ai[static_cast<std::ptrdiff_t>(p) * csa] * x[p]);
+					T& yi = y[static_cast<std::ptrdiff_t>(i) * incy];
+					yi = beta == T(0) ? static_cast<T>(alpha * s) : static_cast<T>(alpha * s + beta * yi);
+				}
+			}, k);
+		}
+	}
+	}
+
+#ifndef BHAVESH_MATRIX_STRASSEN_CROSSOVER
+# define BHAVESH_MATRIX_STRASSEN_CROSSOVER 512 // products with any extent at or below this go straight to the blocked gemm
+#endif
+#ifndef BHAVESH_MATRIX_STRASSEN_RETAIN
+# define BHAVESH_MATRIX_STRASSEN_RETAIN (std::size_t(1) << 24) // bytes of strassen workspace a thread keeps between calls; bigger workspaces are freed on return
+#endif
+
+	inline namespace detail {
+	namespace strassen_detail {
+		/*
+		 * strassen-winograd on row-major operands (unit column stride): 7 half-size products and 15 quadrant additions per level,
+		 * scheduled as in boyer, dumas, pernet and zhou so that a level needs only two temporaries, X (an A-sized quadrant, later P1)
+		 * and Y (a B-sized quadrant); every other intermediate lives in the quadrants of C
+		 * odd extents are peeled: the even core goes through the recursion, the last row / column / depth slice through gemm
+		 */
+
+		// elements of workspace one call needs: X and Y of this level plus whatever the deepest of its products needs
+		inline std::size_t workspace_size(std::size_t m, std::size_t n, std::size_t k, std::size_t crossover) {
+			if (std::min(m, std::min(n, k)) <= crossover) return 0;
+			const std::size_t m2 = m / 2, n2 = n / 2, k2 = k / 2;
+			return m2 * std::max(k2, n2) + k2 * n2 + workspace_size(m2, n2, k2, crossover);
+		}
+
+		// out = x op y over a rows x cols quadrant; whole rows go through the simd kernels, out may be x or y
+		template <simd_detail::elementwise_op op, typename T>
+		inline void quadrant_zip(std::size_t rows, std::size_t cols, const T* x, std::size_t ldx, const T* y, std::size_t ldy, T* out, std::size_t ldo) {
+			const auto row = [=](std::size_t i) { simd_detail::zip<op>(x + i * ldx, y + i * ldy, out + i * ldo, cols); };
+			if (sched_detail::worth_splitting(rows * cols)) {
+				sched_detail::scheduler::instance().parallel_for(rows, row);
+				return;
+			}
+			for (std::size_t i = 0; i != rows; ++i) row(i);
+		}
+
+		// C[m x n] = A[m x k] * B[k x n]; ws holds workspace_size(m, n, k, crossover) elements
+		template <typename T>
+		void multiply(std::size_t m, std::size_t n, std::size_t k, const T* a, std::size_t lda, const T* b, std::size_t ldb, T* c, std::size_t ldc,
+			T* ws, std::size_t crossover) {
+			using op = simd_detail::elementwise_op;
+			if (std::min(m, std::min(n, k)) <= crossover) {
+				gemm_detail::parallel_gemm<T>(m, n, k, T(1), a, static_cast<std::ptrdiff_t>(lda), 1, b, static_cast<std::ptrdiff_t>(ldb), 1,
+					T(0), c, static_cast<std::ptrdiff_t>(ldc), 1);
+				return;
+			}
+
+			const std::size_t m2 = m / 2, n2 = n / 2, k2 = k / 2;
+			const T* a11 = a;            const T* a12 = a + k2;
+			const T* a21 = a + m2 * lda; const T* a22 = a21 + k2;
+			const T* b11 = b;            const T* b12 = b + n2;
+			const T* b21 = b + k2 * ldb; const T* b22 = b21 + n2;
+			T* c11 = c;            T* c12 = c + n2;
+			T* c21 = c + m2 * ldc; T* c22 = c21 + n2;
+
+			const std::size_t ldx = std::max(k2, n2), ldy = n2;
+			T* x = ws;
+			T* y = x + m2 * ldx;
+			T* rest = y + k2 * ldy;
+
+			quadrant_zip<op::sub>(m2, k2, a11, lda, a21, lda, x, ldx);     // S3 = A11 - A21
+			quadrant_zip<op::sub>(k2, n2, b22, ldb, b12, ldb, y, ldy);     // T3 = B22 - B12
+			multiply(m2, n2, k2, x, ldx, y, ldy, c21, ldc, rest, crossover); // P7 = S3 T3
+			quadrant_zip<op::add>(m2, k2, a21, lda, a22, lda, x, ldx);     // S1 = A21 + A22
+			quadrant_zip<op::sub>(k2, n2, b12, ldb, b11, ldb, y, ldy);     // T1 = B12 - B11
+			multiply(m2, n2, k2, x, ldx, y, ldy, c22, ldc, rest, crossover); // P5 = S1 T1
+			quadrant_zip<op::sub>(m2, k2, x, ldx, a11, lda, x, ldx);       // S2 = S1 - A11
+			quadrant_zip<op::sub>(k2, n2, b22, ldb, y, ldy, y, ldy);       // T2 = B22 - T1
+			multiply(m2, n2, k2, x, ldx, y, ldy, c12, ldc, rest, crossover); // P6 = S2 T2
+			quadrant_zip<op::sub>(m2, k2, a12, lda, x, ldx, x, ldx);       // S4 = A12 - S2
+			quadrant_zip<op::sub>(k2, n2, y, ldy, b21, ldb, y, ldy);       // T4 = T2 - B21
+			multiply(m2, n2, k2, x, ldx, b22, ldb, c11, ldc, rest, crossover); // P3 = S4 B22
+			multiply(m2, n2, k2, a11, lda, b11, ldb, x, ldx, rest, crossover); // P1 = A11 B11
+			quadrant_zip<op::add>(m2, n2, x, ldx, c12, ldc, c12, ldc);     // U2 = P1 + P6
+			quadrant_zip<op::add>(m2, n2, c12, ldc, c21, ldc, c21, ldc);   // U3 = U2 + P7
+			quadrant_zip<op::add>(m2, n2, c12, ldc, c22, ldc, c12, ldc);   // U4 = U2 + P5
+			quadrant_zip<op::add>(m2, n2, c21, ldc, c22, ldc, c22, ldc);   // U7 = U3 + P5  -> C22
+			quadrant_zip<op::add>(m2, n2, c12, ldc, c11, ldc, c12, ldc);   // U5 = U4 + P3  -> C12
+			multiply(m2, n2, k2, a22, lda, y, ldy, c11, ldc, rest, crossover); // P4 = A22 T4
+			quadrant_zip<op::sub>(m2, n2, c21, ldc, c11, ldc, c21, ldc);   // U6 = U3 - P4  -> C21
+			multiply(m2, n2, k2, a12, lda, b21, ldb, c11, ldc, rest, crossover); // P2 = A12 B21
+			quadrant_zip<op::add>(m2, n2, x, ldx, c11, ldc, c11, ldc);     // U1 = P1 + P2  -> C11
+
+			// peeling for odd extents
+			const std::ptrdiff_t sa = static_cast<std::ptrdiff_t>(lda), sb = static_cast<std::ptrdiff_t>(ldb), sc = static_cast<std::ptrdiff_t>(ldc);
+			if (k % 2) { // the last column of A times the last row of B, over the even core of C
+				gemm_detail::parallel_gemm<T>(2 * m2, 2 * n2, 1, T(1), a + 2 * k2, sa, 1, b + 2 * k2 * ldb, sb, 1, T(1), c, sc, 1);
+			}
+			if (n % 2) { // the whole last column of C
+				gemm_detail::parallel_gemm<T>(m, 1, k, T(1), a, sa, 1, b + 2 * n2, sb, 1, T(0), c + 2 * n2, sc, 1);
+			}
+			if (m % 2) { // the last row of C, its last element already done above
+				gemm_detail::parallel_gemm<T>(1, 2 * n2, k, T(1), a + 2 * m2 * lda, sa, 1, b, sb, 1, T(0), c + 2 * m2 * ldc, sc, 1);
+			}
+		}
+
+		// workspace for one call; up to BHAVESH_MATRIX_STRASSEN_RETAIN bytes come from a per-thread buffer reused by later calls,
+		// anything bigger is owned by this object and released with it, so one huge product does not pin its workspace for the thread's lifetime
+		template <typename T>
+		class workspace {
+		public:
+			explicit workspace(std::size_t s) {
+				if (s == 0) return; // below the crossover
+				if (s > BHAVESH_MATRIX_STRASSEN_RETAIN / sizeof(T)) {
+					m_owned.reset(new gemm_detail::aligned_buffer<T>(s));
+					m_data = m_owned->data();
+					return;
+				}
+				thread_local std::unique_ptr<gemm_detail::aligned_buffer<T>> buf;
+				thread_local std::size_t capacity = 0;
+				if (capacity < s) {
+					buf.reset();
+					buf.reset(new gemm_detail::aligned_buffer<T>(s));
+					capacity = s;
+				}
+				m_data = buf->data();
+			}
+			workspace(const workspace&) = delete;
+			workspace& operator=(const workspace&) = delete;
+
+			T* data() const { return m_data; }
+
+		private:
+			std::unique_ptr<gemm_detail::aligned_buffer<T>> m_owned;
+			T* m_data = nullptr;
+		};
+	}
+	}
+
+	inline namespace detail {
+	namespace transpose_detail {
+		/*
+		 * transpose engine shared by make_transpose / transpose(...) construction and transpose_inplace
+		 * work goes block by block (both the read and the write side of a block stay in cache and in few pages) and each block by
+		 * w x w micro tiles that are transposed in registers (4x4 for 4 byte types, 2x2 for 8 byte types; plain sse2, so no dispatch)
+		 * non-square in-place transposes where one extent divides the other follow the permutation cycles of whole rows, so they need O(min(m, n)) extra memory;
+		 * other shapes go through the blocked copy into a fresh buffer (element-wise cycle following touches a new cache line per element and is ~10-30x slower)
+		 */
+
+#	ifndef BHAVESH_MATRIX_TRANSPOSE_BLOCK
+#	define BHAVESH_MATRIX_TRANSPOSE_BLOCK 32 // edge of a block in elements; multiple of 4
+#	endif
+		constexpr std::size_t block = BHAVESH_MATRIX_TRANSPOSE_BLOCK;
+
+		template <typename T>
+		struct micro_width : std::integral_constant<std::size_t,
+#	if BHAVESH_MATRIX_X86_SIMD
+			!std::is_trivially_copyable<T>::value ? 1 : sizeof(T) == 4 ? 4 : sizeof(T) == 8 ? 2 : 1
+#	else
+			1
+#	endif
+		> {};
+
+		// dst (w x w, leading dimension ldd) = transpose of src (w x w, leading dimension lds)
+		template <typename T, std::enable_if_t<micro_width<T>::value == 1, int> = 0>
+		inline void micro_copy(const T* src, std::size_t, T* dst, std::size_t) {
+			*dst = *src;
+		}
+#	if BHAVESH_MATRIX_X86_SIMD
+		template <typename T, std::enable_if_t<micro_width<T>::value == 4, int> = 0>
+		inline void micro_copy(const T* src, std::size_t lds, T* dst, std::size_t ldd) {
+			__m128 r0 = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+			__m128 r1 = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + lds)));
+			__m128 r2 = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2 * lds)));
+			__m128 r3 = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 3 * lds)));
+			_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_castps_si128(r0));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + ldd), _mm_castps_si128(r1));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * ldd), _mm_castps_si128(r2));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 3 * ldd), _mm_castps_si128(r3));
+		}
+		template <typename T, std::enable_if_t<micro_width<T>::value == 2, int> = 0>
+		inline void micro_copy(const T* src, std::size_t lds, T* dst, std::size_t ldd) {
+			const __m128i r0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+			const __m128i r1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + lds));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_unpacklo_epi64(r0, r1));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + ldd), _mm_unpackhi_epi64(r0, r1));
+		}
+#	endif
+
+		// swaps the micro tile at p with the transpose of the one at q (p == q transposes it in place)
+		template <typename T>
+		inline void micro_swap(T* p, T* q, std::size_t ld) {
+			constexpr std::size_t w = micro_width<T>::value;
+			if BHAVESH_CXX17_CONSTEXPR(w == 1) {
+				using std::swap;
+				swap(*p, *q);
+			}
+			else {
+				T tmp[w * w];
+				micro_copy(p, ld, tmp, w);
+				if (p != q) micro_copy(q, ld, p, ld);
+				for (std::size_t i = 0; i != w; ++i) {
+					for (std::size_t j = 0; j != w; ++j) q[i * ld + j] = tmp[i * w + j];
+				}
+			}
+		}
+
+		// dst (cols x rows, leading dimension ldd) = transpose of src (rows x cols, leading dimension lds); T trivially copyable
+		template <typename T>
+		inline void copy_tile(const T* src, std::size_t lds, T* dst, std::size_t ldd, std::size_t rows, std::size_t cols) {
+			constexpr std::size_t w = micro_width<T>::value;
+			std::size_t i = 0;
+			for (; i + w <= rows; i += w) {
+				std::size_t j = 0;
+				for (; j + w <= cols; j += w) micro_copy(src + i * lds + j, lds, dst + j * ldd + i, ldd);
+				for (; j != cols; ++j) {
+					for (std::size_t k = i; k != i + w; ++k) dst[j * ldd + k] = src[k * lds + j];
+				}
+			}
+			for (; i != rows; ++i) {
+				for (std::size_t j = 0; j != cols; ++j) dst[j * ldd + i] = src[i * lds + j];
+			}
+		}
+
+		// dst (n x m, contiguous) = transpose of src (m x n, rows lds apart); T trivially copyable
+		// bands of block rows are independent, so big ones are spread over the scheduler
+		template <typename T>
+		inline void transpose_copy(const T* src, std::size_t m, std::size_t n, T* dst, std::size_t lds) {
+			const auto band = [src, m, n, dst, lds](std::size_t ib) {
+				for (std::size_t jb = 0; jb < n; jb += block) {
+					copy_tile(src + ib * lds + jb, lds, dst + jb * m + ib, m, std::min(block, m - ib), std::min(block, n - jb));
+				}
+			};
+			if (sched_detail::worth_splitting(m * n)) {
+				sched_detail::scheduler::instance().parallel_for((m + block - 1) / block, [&band](std::size_t b) { band(b * block); });
+				return;
+			}
+			for (std::size_t ib = 0; ib < m; ib += block) band(ib);
+		}
+		template <typename T>
+		inline void transpose_copy(const T* src, std::size_t m, std::size_t n, T* dst) {
+			transpose_copy(src, m, n, dst, n);
+		}
+
+		// transposes the n x n matrix a in place; band ib swaps the blocks right of the diagonal with their mirrors, so bands never touch the same pair
+		template <typename T>
+		inline void transpose_square(T* a, std::size_t n) {
+			constexpr std::size_t w = micro_width<T>::value;
+			const std::size_t nw = n - n % w; // [0, nw) x [0, nw) is covered by whole micro tiles
+			const auto band = [a, n, nw](std::size_t ib) {
+				const std::size_t ie = std::min(ib + block, nw);
+				for (std::size_t jb = ib; jb < nw; jb += block) {
+					const std::size_t je = std::min(jb + block, nw);
+					for (std::size_t i = ib; i != ie; i += w) {
+						for (std::size_t j = (jb == ib ? i : jb); j != je; j += w) micro_swap(a + i * n + j, a + j * n + i, n);
+					}
+				}
+			};
+			if (sched_detail::worth_splitting(n * n)) {
+				sched_detail::scheduler::instance().parallel_for((nw + block - 1) / block, [&band](std::size_t b) { band(b * block); });
+			}
+			else {
+				for (std::size_t ib = 0; ib < nw; ib += block) band(ib);
+			}
+			for (std::size_t i = 0; i != n; ++i) {
+				for (std::size_t j = std::max(i + 1, nw); j < n; ++j) {
+					using std::swap;
+					swap(a[i * n + j], a[j * n + i]);
+				}
+			}
+		}
+
+		// dst (n x m, uninitialised) = transpose of src (m x n), elements moved across block by block; any T
+		template <typename T>
+		BHAVESH_CXX20_CONSTEXPR void transpose_move(T* src, std::size_t m, std::size_t n, T* dst) {
+			for (std::size_t ib = 0; ib < m; ib += block) {
+				const std::size_t ie = std::min(ib + block, m);
+				for (std::size_t jb = 0; jb < n; jb += block) {
+					const std::size_t je = std::min(jb + block, n);
+					for (std::size_t i = ib; i != ie; ++i) {
+						for (std::size_t j = jb; j != je; ++j) (matrix_detail::construct_at)(dst + j * m + i, std::move_if_noexcept(src[i * n + j]));
+					}
+				}
+			}
+		}
+
+		// same permutation, but on an m x n grid of chunks of c contiguous elements each; scratch holds c elements, T trivially copyable
+		template <typename T>
+		inline void transpose_chunk_cycles(T* a, std::size_t m, std::size_t n, std::size_t c, T* scratch) {
+			const std::size_t s = m * n;
+			if (s < 3) return;
+			const auto dest = [m, n](std::size_t k) { return (k % n) * m + k / n; };
+			for (std::size_t start = 1; start != s - 1; ++start) {
+				std::size_t k = dest(start);
+				while (k > start) k = dest(k);
+				if (k != start) continue;
+				std::memcpy(static_cast<void*>(scratch), static_cast<const void*>(a + start * c), c * sizeof(T));
+				k = start;
+				do {
+					k = dest(k);
+					std::swap_ranges(scratch, scratch + c, a + k * c);
+				} while (k != start);
+			}
+		}
+
+		// m x n -> n x m in place when one extent is a multiple of the other: square blocks are transposed with the tiled kernel
+		// and only whole rows of the shorter extent take part in cycle following; scratch holds min(m, n) elements
+		template <typename T>
+		inline void transpose_divisible(T* a, std::size_t m, std::size_t n, T* scratch) {
+			if (m >= n) { // k stacked n x n blocks; then row r of block i belongs at segment i of row r
+				const std::size_t k = m / n;
+				for (std::size_t i = 0; i != k; ++i) transpose_square(a + i * n * n, n);
+				transpose_chunk_cycles(a, k, n, n, scratch);
+			}
+			else { // each row is k segments of m; gather segment i of every row into block i, then transpose the blocks
+				const std::size_t k = n / m;
+				transpose_chunk_cycles(a, m, k, m, scratch);
+				for (std::size_t i = 0; i != k; ++i) transpose_square(a + i * m * m, m);
+			}
+		}
+	}
+	}
+
+	inline namespace iterators {
+	namespace matrix_iterators {
+
+		template <typename T, typename _tag>
+		class _row_iterator {
+		public:
+			using value_type = std::remove_cv_t<T>;
+			using element_type = T;
+			using difference_type = ptrdiff_t;
+			using reference = T&;
+			using const_reference = const T&;
+			using pointer = T*;
+			using const_pointer = const T*;
+#if BHAVESH_CXX_VER >= 202002L
+			using iterator_category = std::contiguous_iterator_tag;
+			using iterator_concept = std::contiguous_iterator_tag;
+#else
+			using iterator_category = std::random_access_iterator_tag;
+#endif
+		public:
+			constexpr _row_iterator() = default;
+			constexpr _row_iterator(T* data) : m_data(data) {}
+			constexpr _row_iterator(const _row_iterator&) = default;
+			constexpr _row_iterator(_row_iterator&&) = default;
+			constexpr _row_iterator& operator=(const _row_iterator&) = default;
+			constexpr _row_iterator& operator=(_row_iterator&&) = default;
+
+			template<typename X = T, typename = std::enable_if_t<!std::is_const<X>::value>>
+			constexpr operator _row_iterator<const T, _tag>() {
+				return _row_iterator<const T, _tag>(static_cast<const T*>(m_data));
+			}
+
+		public:
+#if BHAVESH_CXX_VER >= 202002L
+			constexpr std::strong_ordering operator<=>(const _row_iterator& it) const { return m_data <=> it.m_data; }
+			constexpr bool operator==(const _row_iterator&) const = default;
 			constexpr bool operator!=(const _row_iterator&) const = default;
 #else
 			constexpr bool operator==(const _row_iterator& it) const { return m_data == it.m_data; }
@@ -652,7 +2442,7 @@ namespace bhavesh {
 			constexpr matrix_column_iterator& operator=(const matrix_column_iterator&) = default;
 			constexpr matrix_column_iterator& operator=(matrix_column_iterator&&) = default;
 
-			template<typename=std::enable_if_t<!std::is_const<T>::value>>
+			template<typename X = T, typename = std::enable_if_t<!std::is_const<X>::value>>
 			constexpr operator matrix_column_iterator<const T>() {
 				return matrix_column_iterator<const T>(static_cast<const T*>(m_data));
 			}
@@ -829,7 +2619,7 @@ namespace bhavesh {
 
 		explicit BHAVESH_CXX20_CONSTEXPR matrix_row(size_t /* m */, size_t n, T* p) : n(n), m_data(p) {}
 		
-		template<typename = std::enable_if_t<!std::is_const<T>::value>>
+		template<typename X = T, typename = std::enable_if_t<!std::is_const<X>::value>>
 		BHAVESH_CXX20_CONSTEXPR operator matrix_row<const T>() {
 			return matrix_row<const T>(std::size_t() /* unused */, n, static_cast<const T*>(m_data));
 		}
@@ -879,7 +2669,7 @@ namespace bhavesh {
 		using element_type = std::remove_cv_t<value_type>;
 		explicit BHAVESH_CXX20_CONSTEXPR matrix_column(size_t m, size_t n, T* p) : m(m), n(n), m_data(p) {}
 		
-		template<typename = std::enable_if_t<!std::is_const<T>::value>>
+		template<typename X = T, typename = std::enable_if_t<!std::is_const<X>::value>>
 		BHAVESH_CXX20_CONSTEXPR operator matrix_column<const T>() {
 			return matrix_column<const T>(m, n, static_cast<const T*>(m_data));
 		}
@@ -903,6 +2693,10 @@ namespace bhavesh {
 			if (i >= m) throw std::out_of_range("Out of range element access attempted for matrix[i][j]");
 			return m_data[i*n];
 		}
+		BHAVESH_CXX20_CONSTEXPR       T* data()         { return m_data; }
+		BHAVESH_CXX20_CONSTEXPR const T* data()   const { return m_data; }
+		// elements between consecutive entries of the column (the row length of the matrix)
+		BHAVESH_CXX20_CONSTEXPR size_t   stride() const { return n; }
 
 		iterator        begin()       { return       iterator{ n, m_data       }; }
 		const_iterator  begin() const { return const_iterator{ n, m_data       }; }
@@ -912,50 +2706,346 @@ namespace bhavesh {
 		const_iterator   cend() const { return const_iterator{ n, m_data + m*n }; }
 		size_t           size() const { return m; }
 
-	private:
-		size_t m;
-		size_t n;
-		T* m_data;
-	};
+	private:
+		size_t m;
+		size_t n;
+		T* m_data;
+	};
+
+	inline namespace detail { namespace matrix_detail { 
+		class transpose_t {}; 
+		class take_ownership_t {}; 
+		class raw_storage_t {};
+		class uninitialized_t {};
+
+		/*
+		 * selects the strassen-winograd product: a.mul(b, strassen) or, with another crossover, a.mul(b, strassen(2048))
+		 * only arithmetic element types take the fast path, anything else gets the ordinary product
+		 * accuracy: the error bound is normwise only, max|C^ - C| <= ((n/n0)^log2(18) * (n0^2 + 6 n0) - 6 n) * eps * max|A| * max|B|
+		 * for n x n operands and crossover n0 (higham), against n * eps * (|A||B|)ij elementwise for the classical product; every level
+		 * below the crossover costs roughly two more bits, and small entries of C next to large ones can lose all their digits.
+		 * strassen_error_bound<T>(n) evaluates that (worst case, usually very pessimistic) factor; with float and large n prefer double inputs
+		 * or the ordinary product whenever C has entries much smaller than max|A| * max|B| that matter
+		 * integer products are exact (barring overflow in the intermediate sums and differences)
+		 */
+		struct strassen_t {
+			std::size_t crossover = BHAVESH_MATRIX_STRASSEN_CROSSOVER;
+
+			constexpr strassen_t operator()(std::size_t n0) const noexcept { return strassen_t{ n0 }; }
+		};
+
+		template<typename T1, typename T2>
+		using addition_t = std::decay_t<decltype(std::declval<T1>() + std::declval<T2>())>;
+
+		template<typename T1, typename T2>
+		using subtraction_t = std::decay_t<decltype(std::declval<T1>() - std::declval<T2>())>;
+		
+		template<typename T1, typename T2>
+		using multiplication_t = std::decay_t<decltype(std::declval<T1>() * std::declval<T2>())>;
+
+	} }
+	
+	constexpr auto transpose = matrix_detail::transpose_t{};
+	constexpr auto matrix_take_ownership = matrix_detail::take_ownership_t{};
+	constexpr auto strassen = matrix_detail::strassen_t{};
+	constexpr auto uninitialized = matrix_detail::uninitialized_t{};
+
+	// the factor of eps * max|A| * max|B| bounding the error of an n x n strassen product, see matrix_detail::strassen_t
+	template <typename T>
+	inline double strassen_error_bound(std::size_t n, matrix_detail::strassen_t mode = strassen) {
+		double levels = 0, n0 = static_cast<double>(n);
+		while (n0 > static_cast<double>(mode.crossover ? mode.crossover : 1)) { n0 /= 2; ++levels; }
+		const double bound = std::pow(18.0, levels) * (n0 * n0 + 6 * n0) - 6.0 * static_cast<double>(n);
+		return std::max(bound, static_cast<double>(n)) * static_cast<double>(std::numeric_limits<T>::epsilon());
+	}
+
+	template <typename T, typename Alloc = BHAVESH_MATRIX_DEFAULT_ALLOCATOR> class matrix;
+
+	template <typename> struct is_matrix : std::false_type {};
+	template <typename T, typename Alloc> struct is_matrix<matrix<T, Alloc>> : std::true_type {};
+#if BHAVESH_CXX17
+	template <typename T>
+	constexpr bool is_matrix_v = is_matrix<T>::value;
+#endif
+#if BHAVESH_CXX20
+	template <typename T>
+	concept matrix_like = is_matrix_v<T>;
+#endif
+
+	template <typename T> class matrix_view;
+	template <typename T> class transposed_view;
+
+	// non-owning strided views that matrix arithmetic accepts in place of a matrix
+	template <typename> struct is_matrix_view : std::false_type {};
+	template <typename T> struct is_matrix_view<matrix_view<T>> : std::true_type {};
+	template <typename T> struct is_matrix_view<transposed_view<T>> : std::true_type {};
+#if BHAVESH_CXX17
+	template <typename T>
+	constexpr bool is_matrix_view_v = is_matrix_view<T>::value;
+#endif
+
+	// compressed sparse matrices (bhavesh_matrix_sparse.h specializes this); matrix and view operators step aside for them so the
+	// mixed dense / sparse operators of that header are the ones chosen
+	template <typename> struct is_sparse_matrix : std::false_type {};
+
+	// statically sized matrices (bhavesh_matrix_fixed.h); matrix operators step aside for them as well, for the mixed operators there
+	template <typename T, std::size_t M, std::size_t N> class fixed_matrix;
+	template <typename> struct is_fixed_matrix : std::false_type {};
+	template <typename T, std::size_t M, std::size_t N> struct is_fixed_matrix<fixed_matrix<T, M, N>> : std::true_type {};
+#if BHAVESH_CXX17
+	template <typename T>
+	constexpr bool is_fixed_matrix_v = is_fixed_matrix<T>::value;
+#endif
+
+	// dense vectors (bhavesh_matrix_vector.h, included at the end of this header) and the row / column views of a matrix;
+	// matrix and view operators step aside for them so that A * x is a matrix-vector product rather than a scalar one
+	template <typename T, typename Alloc = BHAVESH_MATRIX_DEFAULT_ALLOCATOR> class dense_vector;
+	template <typename> struct is_vector_operand : std::false_type {};
+	template <typename T> struct is_vector_operand<matrix_row<T>> : std::true_type {};
+	template <typename T> struct is_vector_operand<matrix_column<T>> : std::true_type {};
+	template <typename T, typename Alloc> struct is_vector_operand<dense_vector<T, Alloc>> : std::true_type {};
+
+	inline namespace detail {
+	namespace vector_detail {
+		// elements between consecutive entries of a vector operand (here rather than in bhavesh_matrix_vector.h, as map.h can be read before it)
+		template <typename T, typename Alloc>
+		constexpr std::ptrdiff_t stride(const dense_vector<T, Alloc>&) noexcept { return 1; }
+		template <typename T>
+		constexpr std::ptrdiff_t stride(const matrix_row<T>&) noexcept { return 1; }
+		template <typename T>
+		constexpr std::ptrdiff_t stride(const matrix_column<T>& c) noexcept { return static_cast<std::ptrdiff_t>(c.stride()); }
+	}
+	}
+
+	// element types the factorizations and solvers work in: floating point types and complex numbers over them
+	template <typename T> struct is_field : std::is_floating_point<T> {};
+	template <typename T> struct is_field<std::complex<T>> : is_field<T> {};
+#if BHAVESH_CXX17
+	template <typename T>
+	constexpr bool is_field_v = is_field<T>::value;
+#endif
+
+	inline namespace detail {
+	namespace linalg_detail {
+		// the element type solutions and inverses are computed in: the type itself for fields, double for integers
+		template <typename T> using field_t = std::conditional_t<std::is_integral<T>::value, double, T>;
+		// the real type underneath: norms, pivot magnitudes (also used by bhavesh_matrix_reduce.h, which can be read before bhavesh_matrix_linalg.h)
+		template <typename T> struct real_of { using type = T; };
+		template <typename T> struct real_of<std::complex<T>> { using type = T; };
+		template <typename T> using real_t = typename real_of<T>::type;
+
+		// defined in bhavesh_matrix_linalg.h, which is included at the end of this header
+		template <typename T, typename Alloc, typename A, typename B> matrix<T, Alloc> solve(const A& a, const B& b);
+		template <typename T, typename Alloc, typename A> matrix<T, Alloc> inverse(const A& a);
+		template <typename T, typename A> T determinant(const A& a);
+	}
+	}
+
+	inline namespace detail {
+	namespace view_detail {
+		template <typename Derived, typename T> class view_base;
+
+		// (row stride, column stride) in elements; this is all the gemm needs to know about the layout of an operand
+		template <typename T, typename Alloc>
+		constexpr std::pair<std::ptrdiff_t, std::ptrdiff_t> strides(const matrix<T, Alloc>& x) {
+			return { static_cast<std::ptrdiff_t>(x.shape().second), 1 };
+		}
+		template <typename V, typename T>
+		constexpr std::pair<std::ptrdiff_t, std::ptrdiff_t> strides(const view_base<V, T>& v) {
+			return { v.row_stride(), v.col_stride() };
+		}
+
+		// visits every (i, j) of an m x n grid tile by tile, so that a strided (e.g. transposed) operand is still read a cache line at a time
+		// large grids hand bands of tile rows to the scheduler, so f must be fine with running concurrently for different (i, j)
+		template <typename F>
+		BHAVESH_CXX20_CONSTEXPR void for_each_blocked(std::size_t m, std::size_t n, F&& f) {
+			constexpr std::size_t b = transpose_detail::block;
+			const auto band = [m, n, &f](std::size_t ib) {
+				for (std::size_t jb = 0; jb < n; jb += b) {
+					const std::size_t ie = std::min(ib + b, m), je = std::min(jb + b, n);
+					for (std::size_t i = ib; i != ie; ++i) {
+						for (std::size_t j = jb; j != je; ++j) f(i, j);
+					}
+				}
+			};
+			if (!matrix_detail::is_constant_evaluated() && sched_detail::worth_splitting(m * n)) {
+				sched_detail::scheduler::instance().parallel_for((m + b - 1) / b, [&band](std::size_t ib) { band(ib * b); });
+				return;
+			}
+			for (std::size_t ib = 0; ib < m; ib += b) band(ib);
+		}
+
+		// d(i, j) = f(d(i, j), s(i, j)); whole rows go through the simd kernels when both sides have contiguous rows
+		// d and s must not partially overlap (d and s being the very same block is fine)
+		template <simd_detail::elementwise_op op, typename D, typename S, typename F>
+		BHAVESH_CXX20_CONSTEXPR void zip_inplace(D& d, const S& s, F&& f) {
+			using TD = std::remove_cv_t<typename D::value_type>;
+			using TS = std::remove_cv_t<typename S::value_type>;
+			const std::size_t m = d.shape().first, n = d.shape().second;
+			if BHAVESH_CXX17_CONSTEXPR(simd_detail::use_kernels<TD, TS, TD>::value) {
+				if (!matrix_detail::is_constant_evaluated()) {
+					const auto sd = strides(d), ss = strides(s);
+					if (sd.second == 1 && ss.second == 1) {
+						for (std::size_t i = 0; i != m; ++i) {
+							TD* row = d.data() + static_cast<std::ptrdiff_t>(i) * sd.first;
+							simd_detail::zip<op>(static_cast<const TD*>(row), s.data() + static_cast<std::ptrdiff_t>(i) * ss.first, row, n);
+						}
+						return;
+					}
+				}
+			}
+			for_each_blocked(m, n, [&d, &s, &f](std::size_t i, std::size_t j) { d._get(i, j) = static_cast<TD>(f(std::move(d._get(i, j)), s._get(i, j))); });
+		}
+
+		template <typename A, typename B>
+		BHAVESH_CXX20_CONSTEXPR bool equal(const A& a, const B& b) {
+			if (a.shape() != b.shape()) return false;
+			const std::size_t m = a.shape().first, n = a.shape().second;
+			for (std::size_t i = 0; i != m; ++i) {
+				for (std::size_t j = 0; j != n; ++j) {
+					if (a._get(i, j) != b._get(i, j)) return false;
+				}
+			}
+			return true;
+		}
+	}
+	}
+
+	inline namespace detail {
+	namespace expression_detail {
+		/*
+		 * opt-in lazy evaluation: bhavesh::lazy(A) + B - C * 2.0 builds a tree of small nodes (pointers + shapes, no storage)
+		 * and nothing is computed until the tree is assigned to a matrix, which then does a single fused pass with a single allocation
+		 * nodes hold their children by value, but leaves only point into matrices; do not keep an expression around past its operands
+		 */
+
+		template <typename E>
+		struct expression {
+			constexpr const E& self() const { return static_cast<const E&>(*this); }
+		};
+
+		struct plus       { template <typename A, typename B> constexpr auto operator()(const A& a, const B& b) const { return a + b; } };
+		struct minus      { template <typename A, typename B> constexpr auto operator()(const A& a, const B& b) const { return a - b; } };
+		struct multiplies { template <typename A, typename B> constexpr auto operator()(const A& a, const B& b) const { return a * b; } };
+
+		template <typename T>
+		class terminal : public expression<terminal<T>> {
+		public:
+			using value_type = T;
+
+			constexpr terminal(const T* data, std::size_t m, std::size_t n) : m_data(data), m(m), n(n) {}
+
+			constexpr const T& operator[](std::size_t i) const { return m_data[i]; }
+			constexpr std::pair<std::size_t, std::size_t> shape() const { return { m, n }; }
+
+		private:
+			const T* m_data;
+			std::size_t m, n;
+		};
+
+		template <typename L, typename R, typename Op>
+		class binary_node : public expression<binary_node<L, R, Op>> {
+		public:
+			using value_type = std::decay_t<decltype(Op{}(std::declval<const typename L::value_type&>(), std::declval<const typename R::value_type&>()))>;
+
+			BHAVESH_CXX20_CONSTEXPR binary_node(const L& l, const R& r) : l(l), r(r) {
+				if (l.shape() != r.shape()) throw std::invalid_argument("Elementwise operations on matrix expressions require same shape");
+			}
+
+			constexpr value_type operator[](std::size_t i) const { return Op{}(l[i], r[i]); }
+			constexpr std::pair<std::size_t, std::size_t> shape() const { return l.shape(); }
+
+			BHAVESH_CXX20_CONSTEXPR matrix<value_type> eval() const { return matrix<value_type>(*this); }
+
+		private:
+			L l;
+			R r;
+		};
+
+		template <typename L, typename S, typename Op>
+		class scalar_node : public expression<scalar_node<L, S, Op>> {
+		public:
+			using value_type = std::decay_t<decltype(Op{}(std::declval<const typename L::value_type&>(), std::declval<const S&>()))>;
+
+			constexpr scalar_node(const L& l, const S& s) : l(l), s(s) {}
+
+			constexpr value_type operator[](std::size_t i) const { return Op{}(l[i], s); }
+			constexpr std::pair<std::size_t, std::size_t> shape() const { return l.shape(); }
+
+			BHAVESH_CXX20_CONSTEXPR matrix<value_type> eval() const { return matrix<value_type>(*this); }
+
+		private:
+			L l;
+			S s;
+		};
+
+		template <typename E>
+		struct is_expression : std::is_base_of<expression<E>, E> {};
 
-	inline namespace detail { namespace matrix_detail { 
-		class transpose_t {}; 
-		class take_ownership_t {}; 
+		// matrices mixed into an expression become leaves; everything else is passed through as is
+		template <typename X, typename = void>
+		struct operand { using type = X; static constexpr const X& get(const X& x) { return x; } };
+		template <typename T, typename Alloc>
+		struct operand<matrix<T, Alloc>> {
+			using type = terminal<T>;
+			static constexpr type get(const matrix<T, Alloc>& x) { return type(x.size() ? &x(0) : nullptr, x.shape().first, x.shape().second); }
+		};
 
-		template<typename T1, typename T2>
-		using addition_t = std::decay_t<decltype(std::declval<T1>() + std::declval<T2>())>;
+		template <typename A, typename B>
+		using enable_if_expression_pair = std::enable_if_t<
+			(is_expression<A>::value && (is_expression<B>::value || is_matrix<B>::value)) ||
+			(is_matrix<A>::value && is_expression<B>::value), int>;
 
-		template<typename T1, typename T2>
-		using subtraction_t = std::decay_t<decltype(std::declval<T1>() - std::declval<T2>())>;
-		
-		template<typename T1, typename T2>
-		using multiplication_t = std::decay_t<decltype(std::declval<T1>() * std::declval<T2>())>;
+		template <typename A, typename B, enable_if_expression_pair<A, B> = 0>
+		BHAVESH_CXX20_CONSTEXPR binary_node<typename operand<A>::type, typename operand<B>::type, plus> operator+(const A& a, const B& b) {
+			return { operand<A>::get(a), operand<B>::get(b) };
+		}
 
-	} }
-	
-	constexpr auto transpose = matrix_detail::transpose_t{};
-	constexpr auto matrix_take_ownership = matrix_detail::take_ownership_t{};
+		template <typename A, typename B, enable_if_expression_pair<A, B> = 0>
+		BHAVESH_CXX20_CONSTEXPR binary_node<typename operand<A>::type, typename operand<B>::type, minus> operator-(const A& a, const B& b) {
+			return { operand<A>::get(a), operand<B>::get(b) };
+		}
 
-	template <typename T> class matrix;
+		template <typename E, typename S, std::enable_if_t<is_expression<E>::value && !is_expression<S>::value && !is_matrix<S>::value && !is_matrix_view<S>::value, int> = 0>
+		constexpr scalar_node<E, S, multiplies> operator*(const E& e, const S& s) {
+			return { e, s };
+		}
 
-	template <typename> struct is_matrix : std::false_type {};
-	template <typename T> struct is_matrix<matrix<T>> : std::true_type {};
-#if BHAVESH_CXX17
-	template <typename T>
-	constexpr bool is_matrix_v = is_matrix<T>::value;
-#endif
-#if BHAVESH_CXX20
-	template <typename T>
-	concept matrix_like = is_matrix_v<T>;
-#endif
+		template <typename S, typename E, std::enable_if_t<is_expression<E>::value && !is_expression<S>::value && !is_matrix<S>::value && !is_matrix_view<S>::value, int> = 0>
+		constexpr scalar_node<E, S, multiplies> operator*(const S& s, const E& e) {
+			return { e, s }; // scalar multiplication is assumed to commute
+		}
 
-	template <typename T>
+		template <typename T, typename Alloc, typename E>
+		BHAVESH_CXX20_CONSTEXPR T* create_from_expression(const E& e, T* buffer = nullptr) {
+			const std::size_t s = e.shape().first * e.shape().second;
+			matrix_detail::construction_holder<T, Alloc> h(s, buffer);
+			if BHAVESH_CXX17_CONSTEXPR(std::is_trivially_copyable<T>::value) {
+				if (!matrix_detail::is_constant_evaluated()) {
+					T* out = h.uninitialized_data();
+					for (std::size_t i = 0; i != s; ++i) (matrix_detail::construct_at)(out + i, static_cast<T>(e[i]));
+					h.commit(s);
+					return h.release<true>();
+				}
+			}
+			for (std::size_t i = 0; i != s; ++i) h.emplace_back(e[i]);
+			return h.release<true>();
+		}
+	}
+	}
+
+	template <typename E>
+	struct is_matrix_expression : expression_detail::is_expression<E> {};
+
+	template <typename T, typename Alloc>
 	class matrix {
+		template <typename, typename> friend class matrix;
+		template <typename, typename> friend class view_detail::view_base;
 	private: /* helper using declarations */
 		template <typename T_>
-		using holder = matrix_detail::construction_holder<T_>;
+		using holder = matrix_detail::construction_holder<T_, Alloc>;
 		template <typename T_>
-		using transpose_holder = matrix_detail::construction_holder_transpose<T_>;
+		using transpose_holder = matrix_detail::construction_holder_transpose<T_, Alloc>;
 	public: /* checks to make sure you dont do dumb stuff */
 		static_assert(!std::is_reference_v<T>, "matrix of reference type is ill-defined");
 		static_assert(!std::is_const_v<T>, "matrix<const T> is ill-defined; use const matrix<T> instead");
@@ -966,54 +3056,64 @@ namespace bhavesh {
 
 	public:
 		using value_type = T;
+		using allocator_type = Alloc;
 
 	public: /* constructors (yes there are really 23 constructors) and destructor */
 		BHAVESH_CXX20_CONSTEXPR matrix() : m_data(nullptr), m(0), n(0) {}
-		BHAVESH_CXX20_CONSTEXPR matrix(matrix&& mat) noexcept : m_data(std::exchange(mat.m_data, nullptr)), m(std::exchange(mat.m, 0)), n(std::exchange(mat.n, 0)) {}
+		BHAVESH_CXX20_CONSTEXPR matrix(matrix&& mat) noexcept : m_data(std::exchange(mat.m_data, nullptr)), m(std::exchange(mat.m, 0)), n(std::exchange(mat.n, 0)) {
+			if (m_data && m_data == mat.m_small.data()) m_data = steal_small(mat);
+		}
 		
 		BHAVESH_CXX20_CONSTEXPR matrix(matrix_detail::take_ownership_t, T*  (&data), std::size_t m, std::size_t n) noexcept : m_data(std::exchange(data, nullptr)), m(m), n(n) {}
 		BHAVESH_CXX20_CONSTEXPR matrix(matrix_detail::take_ownership_t, T* (&&data), std::size_t m, std::size_t n) noexcept : m_data(std::exchange(data, nullptr)), m(m), n(n) {}
 
-		BHAVESH_CXX20_CONSTEXPR matrix(std::size_t m, std::size_t n) : m_data(matrix_detail::create_default_n<T>(m * n)), m(m), n(n) {}
-		BHAVESH_CXX20_CONSTEXPR matrix(std::size_t m, std::size_t n, const T& v) : m_data(matrix_detail::create_fill_n(m * n, v)), m(m), n(n) {}
+		BHAVESH_CXX20_CONSTEXPR matrix(std::size_t m, std::size_t n) : m_data(matrix_detail::create_default_n<T, Alloc>(m * n, small_buffer_for(m * n))), m(m), n(n) {}
+		// elements of a trivial T are left indeterminate (no zero-fill pass): write every one before reading it
+		// any other T, and constant evaluation, still value-initialize
+		BHAVESH_CXX20_CONSTEXPR matrix(std::size_t m, std::size_t n, matrix_detail::uninitialized_t) : m_data(matrix_detail::create_uninitialized_n<T, Alloc>(m * n, small_buffer_for(m * n))), m(m), n(n) {}
+		BHAVESH_CXX20_CONSTEXPR matrix(std::size_t m, std::size_t n, const T& v) : m_data(matrix_detail::create_fill_n<T, Alloc>(m * n, v, small_buffer_for(m * n))), m(m), n(n) {}
 
 		template<typename silence, typename = std::enable_if_t<is_silence_type<silence>::value>>
 		BHAVESH_CXX20_CONSTEXPR matrix(std::size_t m, std::size_t n, std::initializer_list<T> il, silence) :
-			m_data(matrix_detail::create_from_il<silence{}, false>(m, n, il)), m(m), n(n) {}
+			m_data(matrix_detail::create_from_il<silence{}, false, T, Alloc>(m, n, il, small_buffer_for(m * n))), m(m), n(n) {}
 		BHAVESH_CXX20_CONSTEXPR matrix(std::size_t m, std::size_t n, std::initializer_list<T> il) : matrix(m, n, il, silence_none) {}
 		
 		template<typename silence, typename = std::enable_if_t<is_silence_type<silence>::value>>
 		BHAVESH_CXX20_CONSTEXPR matrix(std::size_t m, std::size_t n, std::initializer_list<T> il, silence, matrix_detail::transpose_t) :
-			m_data(matrix_detail::create_from_il<silence{}, true>(m, n, il)), m(m), n(n) {}
+			m_data(matrix_detail::create_from_il<silence{}, true, T, Alloc>(m, n, il, small_buffer_for(m * n))), m(m), n(n) {}
 		template<typename silence, typename = std::enable_if_t<is_silence_type<silence>::value>>
 		BHAVESH_CXX20_CONSTEXPR matrix(std::size_t m, std::size_t n, std::initializer_list<T> il, matrix_detail::transpose_t, silence) :
-			m_data(matrix_detail::create_from_il<silence{}, true>(m, n, il)), m(m), n(n) {}
+			m_data(matrix_detail::create_from_il<silence{}, true, T, Alloc>(m, n, il, small_buffer_for(m * n))), m(m), n(n) {}
 		BHAVESH_CXX20_CONSTEXPR matrix(std::size_t m, std::size_t n, std::initializer_list<T> il, matrix_detail::transpose_t) : matrix(m, n, il, transpose, silence_none) {}
 
 		template<typename silence, typename = std::enable_if_t<is_silence_type<silence>::value>>
 		BHAVESH_CXX20_CONSTEXPR matrix(std::size_t m, std::size_t n, std::initializer_list<std::initializer_list<T>> il, silence) :
-			m_data(matrix_detail::create_from_ilil<silence{}, false>(m, n, il)), m(m), n(n) {}
+			m_data(matrix_detail::create_from_ilil<silence{}, false, T, Alloc>(m, n, il, small_buffer_for(m * n))), m(m), n(n) {}
 		BHAVESH_CXX20_CONSTEXPR matrix(std::size_t m, std::size_t n, std::initializer_list<std::initializer_list<T>> il) : matrix(m, n, il, silence_none) {}
 
 		template<typename silence, typename = std::enable_if_t<is_silence_type<silence>::value>>
 		BHAVESH_CXX20_CONSTEXPR matrix(std::size_t m, std::size_t n, std::initializer_list<std::initializer_list<T>> il, silence, matrix_detail::transpose_t) :
-			m_data(matrix_detail::create_from_ilil<silence{}, true>(m, n, il)), m(m), n(n) {}
+			m_data(matrix_detail::create_from_ilil<silence{}, true, T, Alloc>(m, n, il, small_buffer_for(m * n))), m(m), n(n) {}
 		template<typename silence, typename = std::enable_if_t<is_silence_type<silence>::value>>
 		BHAVESH_CXX20_CONSTEXPR matrix(std::size_t m, std::size_t n, std::initializer_list<std::initializer_list<T>> il, matrix_detail::transpose_t, silence) :
-			m_data(matrix_detail::create_from_ilil<silence{}, true>(m, n, il)), m(m), n(n) {}
+			m_data(matrix_detail::create_from_ilil<silence{}, true, T, Alloc>(m, n, il, small_buffer_for(m * n))), m(m), n(n) {}
 		BHAVESH_CXX20_CONSTEXPR matrix(std::size_t m, std::size_t n, std::initializer_list<std::initializer_list<T>> il, matrix_detail::transpose_t) : matrix(m, n, il, transpose, silence_none) {}
 
-		BHAVESH_CXX20_CONSTEXPR matrix(const matrix& mat) : m_data(matrix_detail::create_from_matrix<false>(mat.m, mat.n, mat.m_data)), m(mat.m), n(mat.n) {}
-		BHAVESH_CXX20_CONSTEXPR matrix(const matrix& mat, matrix_detail::transpose_t) : m_data(matrix_detail::create_from_matrix<true>(mat.m, mat.n, mat.m_data)), m(mat.m), n(mat.n) {}
+		BHAVESH_CXX20_CONSTEXPR matrix(const matrix& mat) : m_data(matrix_detail::create_from_matrix<false, T, Alloc>(mat.m, mat.n, mat.m_data, small_buffer_for(mat.m * mat.n))), m(mat.m), n(mat.n) {}
+		BHAVESH_CXX20_CONSTEXPR matrix(const matrix& mat, matrix_detail::transpose_t) : m_data(create_transposed(mat)), m(mat.n), n(mat.m) {}
+
+		// evaluates a lazy expression (see bhavesh::lazy) in one fused pass
+		template <typename E>
+		BHAVESH_CXX20_CONSTEXPR matrix(const expression_detail::expression<E>& e) : m_data(expression_detail::create_from_expression<T, Alloc>(e.self(), small_buffer_for(e.self().shape().first * e.self().shape().second))), m(e.self().shape().first), n(e.self().shape().second) {}
 
 #if BHAVESH_CXX20 /* range based constructors */
 		
 		template <matrix_detail::matrix_compatible_range<T> R, silence_type silence>
-		constexpr matrix(std::from_range_t, R&& rng, std::size_t m, std::size_t n, silence) : m_data(matrix_detail::create_from_range<silence{}, false, T>(m, n, std::forward<R>(rng))), m(m), n(n) {}
+		constexpr matrix(std::from_range_t, R&& rng, std::size_t m, std::size_t n, silence) : m_data(matrix_detail::create_from_range<silence{}, false, T, Alloc>(m, n, std::forward<R>(rng), small_buffer_for(m * n))), m(m), n(n) {}
 		template <matrix_detail::matrix_compatible_range<T> R, silence_type silence>
-		constexpr matrix(std::from_range_t, R&& rng, std::size_t m, std::size_t n, silence, matrix_detail::transpose_t) : m_data(matrix_detail::create_from_range<silence{}, true, T>(m, n, std::forward<R>(rng))), m(m), n(n) {}
+		constexpr matrix(std::from_range_t, R&& rng, std::size_t m, std::size_t n, silence, matrix_detail::transpose_t) : m_data(matrix_detail::create_from_range<silence{}, true, T, Alloc>(m, n, std::forward<R>(rng), small_buffer_for(m * n))), m(m), n(n) {}
 		template <matrix_detail::matrix_compatible_range<T> R, silence_type silence>
-		constexpr matrix(std::from_range_t, R&& rng, std::size_t m, std::size_t n, matrix_detail::transpose_t, silence) : m_data(matrix_detail::create_from_range<silence{}, true, T>(m, n, std::forward<R>(rng))), m(m), n(n) {}
+		constexpr matrix(std::from_range_t, R&& rng, std::size_t m, std::size_t n, matrix_detail::transpose_t, silence) : m_data(matrix_detail::create_from_range<silence{}, true, T, Alloc>(m, n, std::forward<R>(rng), small_buffer_for(m * n))), m(m), n(n) {}
 		
 		template <matrix_detail::matrix_compatible_range<T> R>
 		constexpr matrix(std::from_range_t, R&& rng, std::size_t m, std::size_t n) : matrix(std::from_range, std::forward<R>(rng), m, n, silence_none) {}
@@ -1025,7 +3125,7 @@ namespace bhavesh {
 		BHAVESH_CXX20_CONSTEXPR ~matrix() {
 			if (m_data) {
 				matrix_detail::destroy_n(m_data, m * n);
-				matrix_detail::deallocate(m_data, m * n);
+				if (!is_small()) matrix_detail::deallocate<T, Alloc>(m_data, m * n);
 #				if BHAVESH_DEBUG
 					m = n = 0;
 					m_data = nullptr;
@@ -1034,28 +3134,45 @@ namespace bhavesh {
 		}
 
 	public: /* conversion operator into another matrix */
-		template<typename Oth, typename=std::enable_if_t<!std::is_same<Oth, T>::value>>
-		BHAVESH_CXX20_CONSTEXPR operator matrix<Oth>() const {
-			return convert_to<Oth>();
+		template<typename Oth, typename OthAlloc, typename=std::enable_if_t<!std::is_same<matrix<Oth, OthAlloc>, matrix>::value>>
+		BHAVESH_CXX20_CONSTEXPR operator matrix<Oth, OthAlloc>() const {
+			return convert_to<Oth, OthAlloc>();
 		}
 
-		template<typename Oth, typename=std::enable_if_t<!std::is_same<Oth, T>::value>>
-		BHAVESH_CXX20_CONSTEXPR matrix<Oth> convert_to() const {
-			holder<Oth> h(m, n);
+		// conversions that cannot throw into a trivially copyable type are written straight into the new storage, split over the scheduler when large
+		template<typename Oth, typename OthAlloc = Alloc, typename=std::enable_if_t<!std::is_same<matrix<Oth, OthAlloc>, matrix>::value>>
+		BHAVESH_CXX20_CONSTEXPR matrix<Oth, OthAlloc> convert_to() const {
+			if BHAVESH_CXX17_CONSTEXPR(std::is_trivially_copyable<Oth>::value && std::is_nothrow_constructible<Oth, const T&>::value) {
+				if (!matrix_detail::is_constant_evaluated()) {
+					matrix<Oth, OthAlloc> ans(matrix_detail::raw_storage_t{}, m, n);
+					Oth* const out = ans.m_data;
+					const T* const in = m_data;
+					sched_detail::for_ranges<Oth>(m * n, [out, in](std::size_t first, std::size_t last) {
+						for (std::size_t i = first; i != last; ++i) (matrix_detail::construct_at)(out + i, in[i]);
+					});
+					return ans;
+				}
+			}
+			matrix_detail::construction_holder<Oth, OthAlloc> h(m, n);
 			const std::size_t s = m * n;
 			for (std::size_t i = 0; i != s; ++i) {
 				h.emplace_back(m_data[i]);
 			}
-			return matrix<Oth>(matrix_take_ownership, h.release<true>(), m, n);
+			return matrix<Oth, OthAlloc>(matrix_take_ownership, h.release<true>(), m, n);
 		}
-		template<typename Oth, typename=std::enable_if_t<!std::is_same<Oth, T>::value>>
-		BHAVESH_CXX20_CONSTEXPR matrix<Oth> convert_to(matrix_detail::transpose_t) const {
-			transpose_holder<Oth> h(m, n);
+		template<typename Oth, typename OthAlloc = Alloc, typename=std::enable_if_t<!std::is_same<matrix<Oth, OthAlloc>, matrix>::value>>
+		BHAVESH_CXX20_CONSTEXPR matrix<Oth, OthAlloc> convert_to(matrix_detail::transpose_t) const {
+			if BHAVESH_CXX17_CONSTEXPR(std::is_trivially_copyable<Oth>::value && std::is_nothrow_constructible<Oth, const T&>::value) {
+				if (!matrix_detail::is_constant_evaluated()) {
+					return matrix<Oth, OthAlloc>::generate_blocked(n, m, [this](std::size_t i, std::size_t j) { return static_cast<Oth>(m_data[j * n + i]); });
+				}
+			}
+			matrix_detail::construction_holder_transpose<Oth, OthAlloc> h(n, m);
 			const std::size_t s = m * n;
 			for (std::size_t i = 0; i != s; ++i) {
 				h.emplace_back(m_data[i]);
 			}
-			return matrix<Oth>(matrix_take_ownership, h.release<true>(), n, m);
+			return matrix<Oth, OthAlloc>(matrix_take_ownership, h.release<true>(), n, m);
 		}
 
 	public: /* assignment operators and transpose functions */
@@ -1068,9 +3185,12 @@ namespace bhavesh {
 				}
 			}
 			else {
-				matrix_detail::destroy_n(m_data, m * n);
-				matrix_detail::deallocate(m_data, m * n);
-				m_data = matrix_detail::create_from_matrix<false>(oth.m, oth.n, oth.m_data);
+				T* data = matrix_detail::create_from_matrix<false, T, Alloc>(oth.m, oth.n, oth.m_data, small_buffer_for(s));
+				if (m_data && data != m_data) {
+					matrix_detail::destroy_n(m_data, m * n);
+					if (!is_small()) matrix_detail::deallocate<T, Alloc>(m_data, m * n);
+				}
+				m_data = data;
 			}
 			m = oth.m;
 			n = oth.n;
@@ -1080,11 +3200,26 @@ namespace bhavesh {
 			if (&oth == this) return *this;
 			if (m_data) {
 				matrix_detail::destroy_n(m_data, m * n);
-				matrix_detail::deallocate(m_data, m * n);
+				if (!is_small()) matrix_detail::deallocate<T, Alloc>(m_data, m * n);
 			}
 			m = std::exchange(oth.m, 0);
 			n = std::exchange(oth.n, 0);
 			m_data = std::exchange(oth.m_data, nullptr);
+			if (m_data && m_data == oth.m_small.data()) m_data = steal_small(oth);
+			return *this;
+		}
+
+		// reuses the current storage when the element count matches; elementwise expressions only ever read index i before writing index i, so operands may alias *this
+		template <typename E>
+		BHAVESH_CXX20_CONSTEXPR matrix& operator=(const expression_detail::expression<E>& e) {
+			const auto sh = e.self().shape();
+			if (sh.first * sh.second != m * n) return *this = matrix(e);
+			const std::size_t s = m * n;
+			for (std::size_t i = 0; i != s; ++i) {
+				m_data[i] = static_cast<T>(e.self()[i]);
+			}
+			m = sh.first;
+			n = sh.second;
 			return *this;
 		}
 
@@ -1092,32 +3227,75 @@ namespace bhavesh {
 			return matrix(*this, transpose);
 		}
 
+		// lazy alternative to make_transpose(): nothing is copied, mul/add/sub/== read through swapped strides
+		BHAVESH_CXX20_CONSTEXPR transposed_view<T> transposed() & {
+			return transposed_view<T>(m_data, n, m, 1, static_cast<std::ptrdiff_t>(n));
+		}
+		BHAVESH_CXX20_CONSTEXPR transposed_view<const T> transposed() const& {
+			return transposed_view<const T>(m_data, n, m, 1, static_cast<std::ptrdiff_t>(n));
+		}
+		void transposed() && = delete; // would dangle
+
+		// zero-copy rows x cols window starting at (r0, c0); writes through it land in this matrix
+		BHAVESH_CXX20_CONSTEXPR matrix_view<T> block(std::size_t r0, std::size_t c0, std::size_t rows, std::size_t cols) & {
+			if (r0 > m || c0 > n || rows > m - r0 || cols > n - c0) throw std::out_of_range("Out of range block requested from matrix");
+			return matrix_view<T>(m_data + r0 * n + c0, rows, cols, n);
+		}
+		BHAVESH_CXX20_CONSTEXPR matrix_view<const T> block(std::size_t r0, std::size_t c0, std::size_t rows, std::size_t cols) const& {
+			if (r0 > m || c0 > n || rows > m - r0 || cols > n - c0) throw std::out_of_range("Out of range block requested from matrix");
+			return matrix_view<const T>(m_data + r0 * n + c0, rows, cols, n);
+		}
+		void block(std::size_t, std::size_t, std::size_t, std::size_t) && = delete; // would dangle
+
 		BHAVESH_CXX20_CONSTEXPR matrix& transpose_inplace() & {
-			// WARNING: MOVES TO NEW MATRIX AND THEN MOVES IT BACK; USES sizeof(T)*m*n + O(1) MEMORY IF M != N; USE transpose() IF YOU WANT A COPY
+			// m != n: O(min(m, n)) extra memory when one extent divides the other (trivially copyable T), otherwise a transposed copy replaces the buffer (m * n extra memory for the duration)
 			if (m == n)
 #if BHAVESH_CXX20
 				[[likely]]
 #endif
 			{
+				if (!matrix_detail::is_constant_evaluated()) {
+					transpose_detail::transpose_square(m_data, n);
+					return *this;
+				}
 				for (size_t i = 0; i < n; ++i) {
 					for (size_t j = i + 1; j < n; ++j) {
 						std::swap(m_data[i * n + j], m_data[j * n + i]);
 					}
 				}
 			}
-			else { // expensive
-				T* cpy = matrix_detail::allocate<T>(m * n);
-				for (size_t i = 0; i < n; ++i) {
-					for (size_t j = 0; j < m; ++j) {
-						(matrix_detail::construct_at)(cpy + i * m + j, std::move_if_noexcept(m_data[j * n + i]));
-					}
-				}
+			else if (is_small()) { // the scratch copy fits on the stack
+				matrix_detail::small_buffer<T> cpy;
+				transpose_detail::transpose_copy(m_data, m, n, cpy.data());
 				const size_t s = m * n;
 				for (size_t i = 0; i < s; ++i) {
-					m_data[i] = std::move_if_noexcept(cpy[i]);
+					m_data[i] = cpy.data()[i];
+				}
+				std::swap(m, n);
+			}
+			else {
+				const std::size_t lo = std::min(m, n), hi = std::max(m, n);
+				if BHAVESH_CXX17_CONSTEXPR(std::is_trivially_copyable<T>::value) {
+					if (lo != 0 && hi % lo == 0 && !matrix_detail::is_constant_evaluated()) {
+						T* scratch = matrix_detail::allocate<T, Alloc>(lo);
+						transpose_detail::transpose_divisible(m_data, m, n, scratch);
+						matrix_detail::deallocate<T, Alloc>(scratch, lo);
+						std::swap(m, n);
+						return *this;
+					}
+				}
+				const std::size_t s = m * n;
+				T* cpy = matrix_detail::allocate<T, Alloc>(s);
+				if BHAVESH_CXX17_CONSTEXPR(std::is_trivially_copyable<T>::value) {
+					if (!matrix_detail::is_constant_evaluated()) transpose_detail::transpose_copy(m_data, m, n, cpy);
+					else transpose_detail::transpose_move(m_data, m, n, cpy);
+				}
+				else {
+					transpose_detail::transpose_move(m_data, m, n, cpy);
 				}
-				matrix_detail::destroy_n(cpy, s);
-				matrix_detail::deallocate(cpy, s);
+				matrix_detail::destroy_n(m_data, s);
+				matrix_detail::deallocate<T, Alloc>(m_data, s);
+				m_data = cpy;
 				std::swap(m, n);
 			}
 			return *this;
@@ -1132,8 +3310,8 @@ namespace bhavesh {
 		BHAVESH_CXX20_CONSTEXPR std::pair<std::size_t, std::size_t> shape() const { return { m, n }; }
 
 	public: /* comparison; note: no operator< as there is no sensible general operator< implementation */
-		template<typename Oth>
-		BHAVESH_CXX20_CONSTEXPR bool operator==(const matrix<Oth>& oth) const {
+		template<typename Oth, typename OthAlloc>
+		BHAVESH_CXX20_CONSTEXPR bool operator==(const matrix<Oth, OthAlloc>& oth) const {
 			if (shape() != oth.shape()) return false;
 			const size_t s = m * n;
 			for (size_t i = 0; i < s; ++i) {
@@ -1142,8 +3320,13 @@ namespace bhavesh {
 			return true;
 		}
 
-		template<typename Oth>
-		BHAVESH_CXX20_CONSTEXPR bool operator!=(const matrix<Oth>& oth) const { return !((*this) == oth); }
+		template<typename Oth, typename OthAlloc>
+		BHAVESH_CXX20_CONSTEXPR bool operator!=(const matrix<Oth, OthAlloc>& oth) const { return !((*this) == oth); }
+
+		template<typename V, typename Oth>
+		BHAVESH_CXX20_CONSTEXPR bool operator==(const view_detail::view_base<V, Oth>& oth) const { return view_detail::equal(*this, oth); }
+		template<typename V, typename Oth>
+		BHAVESH_CXX20_CONSTEXPR bool operator!=(const view_detail::view_base<V, Oth>& oth) const { return !view_detail::equal(*this, oth); }
 
 	public: /* accessors */
 		BHAVESH_CXX20_CONSTEXPR matrix_row<T> operator[](std::size_t i) {
@@ -1158,6 +3341,14 @@ namespace bhavesh {
 #			endif
 			return matrix_row<const T>(m, n, m_data + n * i);
 		}
+		BHAVESH_CXX20_CONSTEXPR matrix_column<T> column(std::size_t j) {
+			if (j >= n) throw std::out_of_range("Out of range column requested from matrix");
+			return matrix_column<T>(m, n, m_data + j);
+		}
+		BHAVESH_CXX20_CONSTEXPR matrix_column<const T> column(std::size_t j) const {
+			if (j >= n) throw std::out_of_range("Out of range column requested from matrix");
+			return matrix_column<const T>(m, n, m_data + j);
+		}
 
 		BHAVESH_CXX20_CONSTEXPR T& operator()(std::size_t idx) {
 #			if BHAVESH_DEBUG
@@ -1210,6 +3401,9 @@ namespace bhavesh {
 			return m_data[idx];
 		}
 
+		BHAVESH_CXX20_CONSTEXPR       T* data()       noexcept { return m_data; }
+		BHAVESH_CXX20_CONSTEXPR const T* data() const noexcept { return m_data; }
+
 	public:
 		BHAVESH_CXX20_CONSTEXPR T get_default(size_t i, size_t j, T default_value = T{}) const noexcept {
 			if (i >= m || j >= n) return std::move_if_noexcept(default_value);
@@ -1217,39 +3411,63 @@ namespace bhavesh {
 		}
 
 	public: /* addition */
-		template<typename By, typename To=matrix_detail::addition_t<const T&, const By&>>
-		BHAVESH_CXX20_CONSTEXPR matrix<To> add(const matrix<By>& oth) const& {
+		template<typename By, typename ByAlloc, typename To=matrix_detail::addition_t<const T&, const By&>>
+		BHAVESH_CXX20_CONSTEXPR matrix<To, Alloc> add(const matrix<By, ByAlloc>& oth) const& {
 			if (oth.shape() != shape()) throw std::invalid_argument("Addition of matrices requires same shape");
 			const std::size_t s = m * n;
+			if BHAVESH_CXX17_CONSTEXPR(std::is_trivially_copyable<To>::value) {
+				if (!matrix_detail::is_constant_evaluated()) {
+					matrix<To, Alloc> ans(matrix_detail::raw_storage_t{}, m, n); // small results stay in ans's inline buffer
+					if BHAVESH_CXX17_CONSTEXPR(simd_detail::use_kernels<T, By, To>::value) {
+						simd_detail::zip<simd_detail::elementwise_op::add>(m_data, oth.m_data, ans.m_data, s);
+					}
+					else {
+						for (std::size_t i = 0; i != s; ++i) (matrix_detail::construct_at)(ans.m_data + i, _get(i) + oth._get(i));
+					}
+					return ans;
+				}
+			}
 			holder<To> h(s);
 			for (std::size_t i = 0; i != s; ++i) {
 				h.emplace_back(_get(i) + oth._get(i));
 			}
-			return matrix<To>(matrix_take_ownership, h.release<true>(), m, n);
+			return matrix<To, Alloc>(matrix_take_ownership, h.release<true>(), m, n);
 		}
 
-		template<typename By, typename=std::enable_if_t<std::is_same<matrix_detail::addition_t<const T&, By>, By>::value>>
-		BHAVESH_CXX20_CONSTEXPR matrix<By>&& add(matrix<By>&& oth) const& {
+		template<typename By, typename ByAlloc, typename=std::enable_if_t<std::is_same<matrix_detail::addition_t<const T&, By>, By>::value>>
+		BHAVESH_CXX20_CONSTEXPR matrix<By, ByAlloc>&& add(matrix<By, ByAlloc>&& oth) const& {
 			if (oth.shape() != shape()) throw std::invalid_argument("Addition of matrices requires same shape");
 			const std::size_t s = m * n;
+			if BHAVESH_CXX17_CONSTEXPR(simd_detail::use_kernels<T, By, By>::value) {
+				if (!matrix_detail::is_constant_evaluated()) {
+					simd_detail::zip<simd_detail::elementwise_op::add>(m_data, oth.m_data, oth.m_data, s);
+					return std::move(oth);
+				}
+			}
 			for (std::size_t i = 0; i != s; ++i) {
 				oth._get(i) = _get(i) + std::move(oth._get(i));
 			}
 			return std::move(oth);
 		}
 
-		template<typename By, typename=std::enable_if_t<std::is_convertible<matrix_detail::addition_t<T, const By&>, T>::value>>
-		BHAVESH_CXX20_CONSTEXPR matrix& add_eq(const matrix<By>& oth) {
+		template<typename By, typename ByAlloc, typename=std::enable_if_t<std::is_convertible<matrix_detail::addition_t<T, const By&>, T>::value>>
+		BHAVESH_CXX20_CONSTEXPR matrix& add_eq(const matrix<By, ByAlloc>& oth) {
 			if (oth.shape() != shape()) throw std::invalid_argument("Addition of matrices requires same shape");
 			const std::size_t s = m * n;
+			if BHAVESH_CXX17_CONSTEXPR(simd_detail::use_kernels<T, By, T>::value) {
+				if (!matrix_detail::is_constant_evaluated()) {
+					simd_detail::zip<simd_detail::elementwise_op::add>(m_data, oth.m_data, m_data, s);
+					return *this;
+				}
+			}
 			for (std::size_t i = 0; i != s; ++i) {
 				m_data[i] = std::move(m_data[i]) + oth._get(i);
 			}
 			return *this;
 		}
 
-		template<typename By, typename=std::enable_if_t<std::is_same<matrix_detail::addition_t<T, const By&>, T>::value>>
-		BHAVESH_CXX20_CONSTEXPR matrix&& add(const matrix<By>& oth) && {
+		template<typename By, typename ByAlloc, typename=std::enable_if_t<std::is_same<matrix_detail::addition_t<T, const By&>, T>::value>>
+		BHAVESH_CXX20_CONSTEXPR matrix&& add(const matrix<By, ByAlloc>& oth) && {
 			return std::move(this->add_eq(oth));
 		}
 
@@ -1258,11 +3476,28 @@ namespace bhavesh {
 			return std::move(this->add_eq(oth));
 		}
 
-		template<typename By>
+		// views (blocks, transposes); contiguous rows go through the simd kernels, anything else is walked tile by tile
+		template<typename V, typename By, typename To=matrix_detail::addition_t<const T&, const By&>>
+		BHAVESH_CXX20_CONSTEXPR matrix<To, Alloc> add(const view_detail::view_base<V, By>& oth) const& {
+			if (oth.shape() != shape()) throw std::invalid_argument("Addition of matrices requires same shape");
+			return matrix<To, Alloc>::template strided_zip<simd_detail::elementwise_op::add>(*this, oth, std::plus<>{});
+		}
+		template<typename V, typename By, typename=std::enable_if_t<std::is_same<matrix_detail::addition_t<T, const By&>, T>::value>>
+		BHAVESH_CXX20_CONSTEXPR matrix&& add(const view_detail::view_base<V, By>& oth) && {
+			return std::move(this->add_eq(oth));
+		}
+		template<typename V, typename By, typename=std::enable_if_t<std::is_convertible<matrix_detail::addition_t<T, const By&>, T>::value>>
+		BHAVESH_CXX20_CONSTEXPR matrix& add_eq(const view_detail::view_base<V, By>& oth) {
+			if (oth.shape() != shape()) throw std::invalid_argument("Addition of matrices requires same shape");
+			view_detail::zip_inplace<simd_detail::elementwise_op::add>(*this, oth, std::plus<>{});
+			return *this;
+		}
+
+		template<typename By, typename=std::enable_if_t<!is_matrix_expression<std::decay_t<By>>::value && !is_fixed_matrix<std::decay_t<By>>::value>>
 		BHAVESH_CXX20_CONSTEXPR decltype(auto) operator+(By&& by) const& {
 			return this->add(std::forward<By>(by));
 		}
-		template<typename By>
+		template<typename By, typename=std::enable_if_t<!is_matrix_expression<std::decay_t<By>>::value && !is_fixed_matrix<std::decay_t<By>>::value>>
 		BHAVESH_CXX20_CONSTEXPR decltype(auto) operator+(By&& by) && {
 			return std::move(*this).add(std::forward<By>(by));
 		}
@@ -1273,39 +3508,63 @@ namespace bhavesh {
 		}
 	
 	public: /* subtraction */
-		template<typename By, typename To=matrix_detail::subtraction_t<const T&, const By&>>
-		BHAVESH_CXX20_CONSTEXPR matrix<To> sub(const matrix<By>& oth) const& {
+		template<typename By, typename ByAlloc, typename To=matrix_detail::subtraction_t<const T&, const By&>>
+		BHAVESH_CXX20_CONSTEXPR matrix<To, Alloc> sub(const matrix<By, ByAlloc>& oth) const& {
 			if (oth.shape() != shape()) throw std::invalid_argument("Subtraction of matrices requires same shape");
 			const std::size_t s = m * n;
+			if BHAVESH_CXX17_CONSTEXPR(std::is_trivially_copyable<To>::value) {
+				if (!matrix_detail::is_constant_evaluated()) {
+					matrix<To, Alloc> ans(matrix_detail::raw_storage_t{}, m, n);
+					if BHAVESH_CXX17_CONSTEXPR(simd_detail::use_kernels<T, By, To>::value) {
+						simd_detail::zip<simd_detail::elementwise_op::sub>(m_data, oth.m_data, ans.m_data, s);
+					}
+					else {
+						for (std::size_t i = 0; i != s; ++i) (matrix_detail::construct_at)(ans.m_data + i, _get(i) - oth._get(i));
+					}
+					return ans;
+				}
+			}
 			holder<To> h(s);
 			for (std::size_t i = 0; i != s; ++i) {
 				h.emplace_back(_get(i) - oth._get(i));
 			}
-			return matrix<To>(matrix_take_ownership, h.release<true>(), m, n);
+			return matrix<To, Alloc>(matrix_take_ownership, h.release<true>(), m, n);
 		}
 
-		template<typename By, typename=std::enable_if_t<std::is_same<matrix_detail::subtraction_t<const T&, By>, By>::value>>
-		BHAVESH_CXX20_CONSTEXPR matrix<By>&& sub(matrix<By>&& oth) const& {
+		template<typename By, typename ByAlloc, typename=std::enable_if_t<std::is_same<matrix_detail::subtraction_t<const T&, By>, By>::value>>
+		BHAVESH_CXX20_CONSTEXPR matrix<By, ByAlloc>&& sub(matrix<By, ByAlloc>&& oth) const& {
 			if (oth.shape() != shape()) throw std::invalid_argument("Subtraction of matrices requires same shape");
 			const std::size_t s = m * n;
+			if BHAVESH_CXX17_CONSTEXPR(simd_detail::use_kernels<T, By, By>::value) {
+				if (!matrix_detail::is_constant_evaluated()) {
+					simd_detail::zip<simd_detail::elementwise_op::sub>(m_data, oth.m_data, oth.m_data, s);
+					return std::move(oth);
+				}
+			}
 			for (std::size_t i = 0; i != s; ++i) {
 				oth._get(i) = _get(i) - std::move(oth._get(i));
 			}
 			return std::move(oth);
 		}
 
-		template<typename By, typename=std::enable_if_t<std::is_convertible<matrix_detail::subtraction_t<T, const By&>, T>::value>>
-		BHAVESH_CXX20_CONSTEXPR matrix& sub_eq(const matrix<By>& oth) {
+		template<typename By, typename ByAlloc, typename=std::enable_if_t<std::is_convertible<matrix_detail::subtraction_t<T, const By&>, T>::value>>
+		BHAVESH_CXX20_CONSTEXPR matrix& sub_eq(const matrix<By, ByAlloc>& oth) {
 			if (oth.shape() != shape()) throw std::invalid_argument("Subtraction of matrices requires same shape");
 			const std::size_t s = m * n;
+			if BHAVESH_CXX17_CONSTEXPR(simd_detail::use_kernels<T, By, T>::value) {
+				if (!matrix_detail::is_constant_evaluated()) {
+					simd_detail::zip<simd_detail::elementwise_op::sub>(m_data, oth.m_data, m_data, s);
+					return *this;
+				}
+			}
 			for (std::size_t i = 0; i != s; ++i) {
 				m_data[i] = std::move(m_data[i]) - oth._get(i);
 			}
 			return *this;
 		}
 
-		template<typename By, typename=std::enable_if_t<std::is_same<matrix_detail::subtraction_t<T, const By&>, T>::value>>
-		BHAVESH_CXX20_CONSTEXPR matrix&& sub(const matrix<By>& oth) && {
+		template<typename By, typename ByAlloc, typename=std::enable_if_t<std::is_same<matrix_detail::subtraction_t<T, const By&>, T>::value>>
+		BHAVESH_CXX20_CONSTEXPR matrix&& sub(const matrix<By, ByAlloc>& oth) && {
 			return std::move(this->sub_eq(oth));
 		}
 
@@ -1314,11 +3573,28 @@ namespace bhavesh {
 			return std::move(this->sub_eq(oth));
 		}
 
-		template<typename By>
+		// views (blocks, transposes); contiguous rows go through the simd kernels, anything else is walked tile by tile
+		template<typename V, typename By, typename To=matrix_detail::subtraction_t<const T&, const By&>>
+		BHAVESH_CXX20_CONSTEXPR matrix<To, Alloc> sub(const view_detail::view_base<V, By>& oth) const& {
+			if (oth.shape() != shape()) throw std::invalid_argument("Subtraction of matrices requires same shape");
+			return matrix<To, Alloc>::template strided_zip<simd_detail::elementwise_op::sub>(*this, oth, std::minus<>{});
+		}
+		template<typename V, typename By, typename=std::enable_if_t<std::is_same<matrix_detail::subtraction_t<T, const By&>, T>::value>>
+		BHAVESH_CXX20_CONSTEXPR matrix&& sub(const view_detail::view_base<V, By>& oth) && {
+			return std::move(this->sub_eq(oth));
+		}
+		template<typename V, typename By, typename=std::enable_if_t<std::is_convertible<matrix_detail::subtraction_t<T, const By&>, T>::value>>
+		BHAVESH_CXX20_CONSTEXPR matrix& sub_eq(const view_detail::view_base<V, By>& oth) {
+			if (oth.shape() != shape()) throw std::invalid_argument("Subtraction of matrices requires same shape");
+			view_detail::zip_inplace<simd_detail::elementwise_op::sub>(*this, oth, std::minus<>{});
+			return *this;
+		}
+
+		template<typename By, typename=std::enable_if_t<!is_matrix_expression<std::decay_t<By>>::value && !is_fixed_matrix<std::decay_t<By>>::value>>
 		BHAVESH_CXX20_CONSTEXPR decltype(auto) operator-(By&& by) const& {
 			return this->sub(std::forward<By>(by));
 		}
-		template<typename By>
+		template<typename By, typename=std::enable_if_t<!is_matrix_expression<std::decay_t<By>>::value && !is_fixed_matrix<std::decay_t<By>>::value>>
 		BHAVESH_CXX20_CONSTEXPR decltype(auto) operator-(By&& by) && {
 			return std::move(*this).sub(std::forward<By>(by));
 		}
@@ -1329,19 +3605,37 @@ namespace bhavesh {
 		}
 	
 	public: /* scalar(-like) multiplication */
-		template<typename By, typename To=matrix_detail::multiplication_t<const T&, const By&>, typename=std::enable_if_t<!is_matrix<std::decay_t<By>>::value>>
-		BHAVESH_CXX20_CONSTEXPR matrix<To> mul(const By& oth) const {
+		template<typename By, typename To=matrix_detail::multiplication_t<const T&, const By&>, typename=std::enable_if_t<!is_matrix<std::decay_t<By>>::value && !is_matrix_view<std::decay_t<By>>::value && !is_vector_operand<std::decay_t<By>>::value>>
+		BHAVESH_CXX20_CONSTEXPR matrix<To, Alloc> mul(const By& oth) const {
 			const std::size_t s = m * n;
+			if BHAVESH_CXX17_CONSTEXPR(std::is_trivially_copyable<To>::value) {
+				if (!matrix_detail::is_constant_evaluated()) {
+					matrix<To, Alloc> ans(matrix_detail::raw_storage_t{}, m, n);
+					if BHAVESH_CXX17_CONSTEXPR(simd_detail::use_kernels<T, By, To>::value) {
+						simd_detail::broadcast<simd_detail::elementwise_op::mul>(m_data, oth, ans.m_data, s);
+					}
+					else {
+						for (std::size_t i = 0; i != s; ++i) (matrix_detail::construct_at)(ans.m_data + i, _get(i) * oth);
+					}
+					return ans;
+				}
+			}
 			holder<To> h(s);
 			for (std::size_t i = 0; i != s; ++i) {
 				h.emplace_back(_get(i) * oth);
 			}
-			return matrix<To>(matrix_take_ownership, h.release<true>(), m, n);
+			return matrix<To, Alloc>(matrix_take_ownership, h.release<true>(), m, n);
 		}
 
-		template<typename By, typename=std::enable_if_t<std::is_convertible<matrix_detail::multiplication_t<T, const By&>, T>::value>, typename=std::enable_if_t<!is_matrix<std::decay_t<By>>::value>>
+		template<typename By, typename=std::enable_if_t<std::is_convertible<matrix_detail::multiplication_t<T, const By&>, T>::value>, typename=std::enable_if_t<!is_matrix<std::decay_t<By>>::value && !is_matrix_view<std::decay_t<By>>::value>>
 		BHAVESH_CXX20_CONSTEXPR matrix& mul_eq(const By& oth) {
 			const std::size_t s = m * n;
+			if BHAVESH_CXX17_CONSTEXPR(simd_detail::use_kernels<T, By, matrix_detail::multiplication_t<T, const By&>>::value) {
+				if (!matrix_detail::is_constant_evaluated()) {
+					simd_detail::broadcast<simd_detail::elementwise_op::mul>(m_data, oth, m_data, s);
+					return *this;
+				}
+			}
 			for (std::size_t i = 0; i != s; ++i) {
 				_get(i) = static_cast<T>(std::move(_get(i)) * oth);
 			}
@@ -1349,28 +3643,42 @@ namespace bhavesh {
 		}
 
 	public: /* matrix-matrix multiplication */
-		template<typename By, typename To=matrix_detail::multiplication_t<const T&, const By&>>
-		BHAVESH_CXX20_CONSTEXPR matrix<To> mul(const matrix<By>& oth) const {
+		template<typename By, typename ByAlloc, typename To=matrix_detail::multiplication_t<const T&, const By&>>
+		BHAVESH_CXX20_CONSTEXPR matrix<To, Alloc> mul(const matrix<By, ByAlloc>& oth) const {
+			return matrix<To, Alloc>::strided_mul(*this, oth);
+		}
+		// the view is handed to the gemm as a layout (strides); it is never materialized
+		template<typename V, typename By, typename To=matrix_detail::multiplication_t<const T&, const By&>>
+		BHAVESH_CXX20_CONSTEXPR matrix<To, Alloc> mul(const view_detail::view_base<V, By>& oth) const {
+			return matrix<To, Alloc>::strided_mul(*this, oth);
+		}
+		// opt-in strassen-winograd (see matrix_detail::strassen_t for the accuracy trade-off); intermediates come from a per-thread workspace (see strassen_detail::workspace)
+		template<typename By, typename ByAlloc, typename To=matrix_detail::multiplication_t<const T&, const By&>>
+		BHAVESH_CXX20_CONSTEXPR matrix<To, Alloc> mul(const matrix<By, ByAlloc>& oth, matrix_detail::strassen_t mode) const {
 			if (shape().second != oth.shape().first) throw std::invalid_argument("Invalid shapes for multiplication of matrices");
-			
-			matrix<To> answer(m, oth.shape().second);
-
-			const std::size_t m1 = this->m, l1 = this->n, n1 = oth.shape().second;
-			for (std::size_t i = 0; i < m1; ++i) {
-				for (std::size_t j = 0; j != l1; ++j) {
-					for (std::size_t k = 0; k != n1; ++k) {
-						answer._get(i, k) = answer._get(i, k) + this->_get(i, j) * oth._get(j, k);
-					}
+			if BHAVESH_CXX17_CONSTEXPR(gemm_detail::use_blocked_gemm<T, By, To>::value) {
+				if (!matrix_detail::is_constant_evaluated()) {
+					const std::size_t n1 = oth.shape().second, crossover = std::max<std::size_t>(mode.crossover, 16);
+					matrix<To, Alloc> answer(matrix_detail::raw_storage_t{}, m, n1);
+					if (answer.size() == 0) return answer;
+					const strassen_detail::workspace<T> ws(strassen_detail::workspace_size(m, n1, n, crossover));
+					strassen_detail::multiply<T>(m, n1, n, m_data, n, oth.data(), n1, answer.m_data, n1, ws.data(), crossover);
+					return answer;
 				}
 			}
-			return answer;
+			return this->mul(oth);
 		}
 #if BHAVESH_CXX17
-		template<typename By, typename To=matrix_detail::multiplication_t<const T&, const By&>, typename ExecutionPolicy, typename=std::enable_if_t<std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>>>
-		matrix<To> mul(ExecutionPolicy&& policy, const matrix<By>& oth) const {
+		// arithmetic types run the blocked gemm over 2d tiles of C on matrix_scheduler's pool like the plain mul (std::execution::seq keeps it on the calling thread)
+		// anything else is split one row of C per index through the standard algorithm
+		template<typename By, typename ByAlloc, typename To=matrix_detail::multiplication_t<const T&, const By&>, typename ExecutionPolicy, typename=std::enable_if_t<std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>>>
+		matrix<To, Alloc> mul(ExecutionPolicy&& policy, const matrix<By, ByAlloc>& oth) const {
 			if (shape().second != oth.shape().first) throw std::invalid_argument("Invalid shapes for multiplication of matrices");
+			if constexpr (gemm_detail::use_blocked_gemm<T, By, To>::value) {
+				return matrix<To, Alloc>::template strided_mul<!std::is_same<std::remove_cvref_t<ExecutionPolicy>, std::execution::sequenced_policy>::value>(*this, oth);
+			}
 			
-			matrix<To> answer(m, oth.shape().second);
+			matrix<To, Alloc> answer(m, oth.shape().second);
 
 			const std::size_t m1 = this->m, l1 = this->n, n1 = oth.shape().second;
 			std::for_each(std::forward<ExecutionPolicy>(policy), 
@@ -1384,7 +3692,7 @@ namespace bhavesh {
 			return answer;
 		}
 #endif
-		template<typename By>
+		template<typename By, typename=std::enable_if_t<!is_matrix_expression<std::decay_t<By>>::value && !is_sparse_matrix<std::decay_t<By>>::value && !is_vector_operand<std::decay_t<By>>::value && !is_fixed_matrix<std::decay_t<By>>::value>>
 		BHAVESH_CXX20_CONSTEXPR decltype(auto) operator*(By&& by) const {
 			return this->mul(std::forward<By>(by));
 		}
@@ -1394,12 +3702,480 @@ namespace bhavesh {
 			return this->mul_eq(std::forward<By>(by));
 		}
 
+	public: /* linear systems (see bhavesh_matrix_linalg.h); integer matrices are solved and inverted in double */
+		using inverse_type = matrix<linalg_detail::field_t<T>, Alloc>;
+
+		// X with A X = B for square A (blocked LU, every column of B in the same triangular passes), the least squares X for tall A (QR)
+		// prefer this to inverse() * B: it is cheaper and more accurate
+		template <typename B, typename = std::enable_if_t<is_matrix<B>::value || is_matrix_view<B>::value>>
+		inverse_type solve(const B& b) const {
+			return linalg_detail::solve<linalg_detail::field_t<T>, Alloc>(*this, b);
+		}
+		// throws std::domain_error for a singular matrix
+		inverse_type inverse() const {
+			return linalg_detail::inverse<linalg_detail::field_t<T>, Alloc>(*this);
+		}
+		// by LU for fields; exact (fraction-free elimination) for integers
+		T determinant() const {
+			return linalg_detail::determinant<T>(*this);
+		}
+
+	private: /* kernels shared with the views; A and B are matrices or views, anything with shape(), _get(i, j), data() and view_detail::strides */
+		template <bool parallel = true, typename A, typename B>
+		static BHAVESH_CXX20_CONSTEXPR matrix strided_mul(const A& a, const B& b) {
+			if (a.shape().second != b.shape().first) throw std::invalid_argument("Invalid shapes for multiplication of matrices");
+
+			const std::size_t m1 = a.shape().first, l1 = a.shape().second, n1 = b.shape().second;
+
+			using TA = std::remove_cv_t<typename A::value_type>;
+			using TB = std::remove_cv_t<typename B::value_type>;
+			if BHAVESH_CXX17_CONSTEXPR(gemm_detail::use_blocked_gemm<TA, TB, T>::value) {
+				if (!matrix_detail::is_constant_evaluated()) {
+					matrix answer(m1, n1, matrix_detail::uninitialized_t{}); // beta == 0: the gemm never reads it
+					const auto sa = view_detail::strides(a), sb = view_detail::strides(b);
+					if (parallel && (n1 == 1 || m1 == 1)) { // matrix-vector shapes: packing gemm panels would cost as much as the product itself
+						if (n1 == 1) gemv_detail::gemv<T>(m1, l1, T(1), a.data(), sa.first, sa.second, b.data(), sb.first, T(0), answer.m_data, 1);
+						else gemv_detail::gemv<T>(n1, l1, T(1), b.data(), sb.second, sb.first, a.data(), sa.second, T(0), answer.m_data, 1);
+						return answer;
+					}
+					(parallel ? gemm_detail::parallel_gemm<T> : gemm_detail::gemm<T>)(m1, n1, l1, T(1), a.data(), sa.first, sa.second, b.data(), sb.first, sb.second,
+						T(0), answer.m_data, static_cast<std::ptrdiff_t>(n1), 1);
+					return answer;
+				}
+			}
+			// generic fallback; also the constexpr path
+			matrix answer(m1, n1);
+			for (std::size_t i = 0; i < m1; ++i) {
+				for (std::size_t j = 0; j != l1; ++j) {
+					for (std::size_t k = 0; k != n1; ++k) {
+						answer._get(i, k) = answer._get(i, k) + a._get(i, j) * b._get(j, k);
+					}
+				}
+			}
+			return answer;
+		}
+
+		// m x n matrix of f(i, j); trivially copyable results are written tile by tile straight into the storage
+		template <typename F>
+		static BHAVESH_CXX20_CONSTEXPR matrix generate_blocked(std::size_t m, std::size_t n, F&& f) {
+			if BHAVESH_CXX17_CONSTEXPR(std::is_trivially_copyable<T>::value) {
+				if (!matrix_detail::is_constant_evaluated()) {
+					matrix ans(matrix_detail::raw_storage_t{}, m, n);
+					view_detail::for_each_blocked(m, n, [&ans, &f](std::size_t i, std::size_t j) { (matrix_detail::construct_at)(ans.m_data + i * ans.n + j, f(i, j)); });
+					return ans;
+				}
+			}
+			holder<T> h(m, n);
+			for (std::size_t i = 0; i != m; ++i) {
+				for (std::size_t j = 0; j != n; ++j) h.emplace_back(f(i, j));
+			}
+			return matrix(matrix_take_ownership, h.release<true>(), m, n);
+		}
+
+		// a + b or a - b for equally shaped operands; rows are zipped with the simd kernels when both sides store them contiguously
+		template <simd_detail::elementwise_op op, typename A, typename B, typename F>
+		static BHAVESH_CXX20_CONSTEXPR matrix strided_zip(const A& a, const B& b, F f) {
+			const std::size_t m = a.shape().first, n = a.shape().second;
+			using TA = std::remove_cv_t<typename A::value_type>;
+			using TB = std::remove_cv_t<typename B::value_type>;
+			if BHAVESH_CXX17_CONSTEXPR(simd_detail::use_kernels<TA, TB, T>::value) {
+				if (!matrix_detail::is_constant_evaluated()) {
+					const auto sa = view_detail::strides(a), sb = view_detail::strides(b);
+					if (sa.second == 1 && sb.second == 1) {
+						matrix ans(matrix_detail::raw_storage_t{}, m, n);
+						for (std::size_t i = 0; i != m; ++i) {
+							simd_detail::zip<op>(static_cast<const T*>(a.data() + static_cast<std::ptrdiff_t>(i) * sa.first),
+								static_cast<const T*>(b.data() + static_cast<std::ptrdiff_t>(i) * sb.first), ans.m_data + i * n, n);
+						}
+						return ans;
+					}
+				}
+			}
+			return generate_blocked(m, n, [&a, &b, &f](std::size_t i, std::size_t j) { return f(a._get(i, j), b._get(i, j)); });
+		}
+
+	private: /* small buffer */
+		static constexpr std::size_t small_capacity = matrix_detail::small_buffer_capacity<T>::value;
+
+		// where to build s elements without touching the allocator, or nullptr if they have to go on the heap
+		BHAVESH_CXX20_CONSTEXPR T* small_buffer_for(std::size_t s) noexcept {
+			if (s == 0 || s > small_capacity || matrix_detail::is_constant_evaluated()) return nullptr;
+			return m_small.data();
+		}
+		BHAVESH_CXX20_CONSTEXPR bool is_small() const noexcept {
+			return m_data != nullptr && m_data == m_small.data();
+		}
+		// the small buffer cannot be handed over like a heap pointer; copy it (T is trivial) into our own
+		BHAVESH_CXX20_CONSTEXPR T* steal_small(matrix& from) noexcept {
+			const std::size_t s = m * n;
+			for (std::size_t i = 0; i != s; ++i) m_small.data()[i] = from.m_small.data()[i];
+			return m_small.data();
+		}
+
+		// storage holding the transpose of mat; blocked + register tiled for trivially copyable T
+		BHAVESH_CXX20_CONSTEXPR T* create_transposed(const matrix& mat) {
+			const std::size_t s = mat.m * mat.n;
+			if BHAVESH_CXX17_CONSTEXPR(std::is_trivially_copyable<T>::value) {
+				if (!matrix_detail::is_constant_evaluated()) {
+					T* out = small_buffer_for(s);
+					if (!out) out = matrix_detail::allocate<T, Alloc>(s);
+					transpose_detail::transpose_copy(mat.m_data, mat.m, mat.n, out);
+					return out;
+				}
+			}
+			return matrix_detail::create_from_matrix<true, T, Alloc>(mat.n, mat.m, mat.m_data, small_buffer_for(s));
+		}
+
+		// room for m * n elements without constructing them; T must be trivially copyable and every element written before it is read
+		BHAVESH_CXX20_CONSTEXPR matrix(matrix_detail::raw_storage_t, std::size_t m, std::size_t n) : m_data(small_buffer_for(m * n)), m(m), n(n) {
+			if (!m_data) m_data = matrix_detail::allocate<T, Alloc>(m * n);
+		}
+
 	private:
 		T* m_data;
 		std::size_t m;
 		std::size_t n;
+		BHAVESH_NO_UNIQUE_ADDRESS matrix_detail::small_buffer<T> m_small;
+	};
+
+	inline namespace detail {
+	namespace view_detail {
+		/*
+		 * shared body of the non-owning views: element (i, j) is data[i * row_stride + j * col_stride]
+		 * add/sub/mul/== accept matrices and other views and always produce ordinary matrices; the in-place operations
+		 * write through the view into the matrix it looks at. constness comes from T, the view itself is just a pointer
+		 * the viewed matrix must outlive the view and keep its shape
+		 */
+		template <typename Derived, typename T>
+		class view_base {
+		public:
+			using value_type = std::remove_const_t<T>;
+
+		protected:
+			BHAVESH_CXX20_CONSTEXPR view_base(T* data, std::size_t m, std::size_t n, std::ptrdiff_t rs, std::ptrdiff_t cs) noexcept
+				: m_data(data), m(m), n(n), rs(rs), cs(cs) {}
+
+		public: /* shape information */
+			BHAVESH_CXX20_CONSTEXPR std::size_t size() const noexcept { return m * n; }
+			BHAVESH_CXX20_CONSTEXPR std::pair<std::size_t, std::size_t> shape() const noexcept { return { m, n }; }
+			BHAVESH_CXX20_CONSTEXPR std::ptrdiff_t row_stride() const noexcept { return rs; }
+			BHAVESH_CXX20_CONSTEXPR std::ptrdiff_t col_stride() const noexcept { return cs; }
+			BHAVESH_CXX20_CONSTEXPR T* data() const noexcept { return m_data; }
+
+		public: /* accessors */
+			BHAVESH_CXX20_CONSTEXPR T& operator()(std::size_t i, std::size_t j) const {
+#				if BHAVESH_DEBUG
+					if (i >= m || j >= n) throw std::out_of_range("Out of range element access attempted for matrix(i, j)");
+#				endif
+				return _get(i, j);
+			}
+			BHAVESH_CXX20_CONSTEXPR T& get(std::size_t i, std::size_t j) const {
+				if (i >= m || j >= n) throw std::out_of_range("Out of range element access attempted for matrix[i][j]");
+				return _get(i, j);
+			}
+			BHAVESH_CXX20_CONSTEXPR T& _get(std::size_t i, std::size_t j) const {
+				return m_data[static_cast<std::ptrdiff_t>(i) * rs + static_cast<std::ptrdiff_t>(j) * cs];
+			}
+
+		public: /* materialization */
+			template <typename Alloc = BHAVESH_MATRIX_DEFAULT_ALLOCATOR>
+			BHAVESH_CXX20_CONSTEXPR matrix<value_type, Alloc> to_matrix() const {
+				if BHAVESH_CXX17_CONSTEXPR(std::is_trivially_copyable<value_type>::value) {
+					if (!matrix_detail::is_constant_evaluated()) {
+						const value_type* src = m_data;
+						if (cs == 1) { // contiguous rows
+							matrix<value_type, Alloc> ans(matrix_detail::raw_storage_t{}, m, n);
+							for (std::size_t i = 0; i != m; ++i) {
+								if (n) std::memcpy(ans.m_data + i * n, src + static_cast<std::ptrdiff_t>(i) * rs, n * sizeof(value_type));
+							}
+							return ans;
+						}
+						if (rs == 1 && cs > 0) { // contiguous columns, i.e. a transposed block
+							matrix<value_type, Alloc> ans(matrix_detail::raw_storage_t{}, m, n);
+							transpose_detail::transpose_copy(src, n, m, ans.m_data, static_cast<std::size_t>(cs));
+							return ans;
+						}
+					}
+				}
+				return matrix<value_type, Alloc>::generate_blocked(m, n, [this](std::size_t i, std::size_t j) { return _get(i, j); });
+			}
+
+		public: /* arithmetic; results are ordinary matrices */
+			template <typename By, typename ByAlloc, typename To = matrix_detail::addition_t<const T&, const By&>>
+			BHAVESH_CXX20_CONSTEXPR matrix<To, ByAlloc> add(const matrix<By, ByAlloc>& oth) const {
+				if (oth.shape() != shape()) throw std::invalid_argument("Addition of matrices requires same shape");
+				return matrix<To, ByAlloc>::template strided_zip<simd_detail::elementwise_op::add>(self(), oth, std::plus<>{});
+			}
+			template <typename V, typename By, typename To = matrix_detail::addition_t<const T&, const By&>, typename Alloc = BHAVESH_MATRIX_DEFAULT_ALLOCATOR>
+			BHAVESH_CXX20_CONSTEXPR matrix<To, Alloc> add(const view_base<V, By>& oth) const {
+				if (oth.shape() != shape()) throw std::invalid_argument("Addition of matrices requires same shape");
+				return matrix<To, Alloc>::template strided_zip<simd_detail::elementwise_op::add>(self(), oth, std::plus<>{});
+			}
+
+			template <typename By, typename ByAlloc, typename To = matrix_detail::subtraction_t<const T&, const By&>>
+			BHAVESH_CXX20_CONSTEXPR matrix<To, ByAlloc> sub(const matrix<By, ByAlloc>& oth) const {
+				if (oth.shape() != shape()) throw std::invalid_argument("Subtraction of matrices requires same shape");
+				return matrix<To, ByAlloc>::template strided_zip<simd_detail::elementwise_op::sub>(self(), oth, std::minus<>{});
+			}
+			template <typename V, typename By, typename To = matrix_detail::subtraction_t<const T&, const By&>, typename Alloc = BHAVESH_MATRIX_DEFAULT_ALLOCATOR>
+			BHAVESH_CXX20_CONSTEXPR matrix<To, Alloc> sub(const view_base<V, By>& oth) const {
+				if (oth.shape() != shape()) throw std::invalid_argument("Subtraction of matrices requires same shape");
+				return matrix<To, Alloc>::template strided_zip<simd_detail::elementwise_op::sub>(self(), oth, std::minus<>{});
+			}
+
+			// the strides are handed to the gemm as a layout; neither operand is materialized
+			template <typename By, typename ByAlloc, typename To = matrix_detail::multiplication_t<const T&, const By&>>
+			BHAVESH_CXX20_CONSTEXPR matrix<To, ByAlloc> mul(const matrix<By, ByAlloc>& oth) const {
+				return matrix<To, ByAlloc>::strided_mul(self(), oth);
+			}
+			template <typename V, typename By, typename To = matrix_detail::multiplication_t<const T&, const By&>, typename Alloc = BHAVESH_MATRIX_DEFAULT_ALLOCATOR>
+			BHAVESH_CXX20_CONSTEXPR matrix<To, Alloc> mul(const view_base<V, By>& oth) const {
+				return matrix<To, Alloc>::strided_mul(self(), oth);
+			}
+			template <typename By, typename To = matrix_detail::multiplication_t<const T&, const By&>, typename = std::enable_if_t<!is_matrix<By>::value && !is_matrix_view<By>::value && !is_vector_operand<By>::value>>
+			BHAVESH_CXX20_CONSTEXPR matrix<To> mul(const By& oth) const {
+				return matrix<To>::generate_blocked(m, n, [this, &oth](std::size_t i, std::size_t j) { return _get(i, j) * oth; });
+			}
+
+			template <typename By>
+			BHAVESH_CXX20_CONSTEXPR auto operator+(const By& by) const { return this->add(by); }
+			template <typename By>
+			BHAVESH_CXX20_CONSTEXPR auto operator-(const By& by) const { return this->sub(by); }
+			template <typename By, typename = std::enable_if_t<!is_sparse_matrix<By>::value && !is_vector_operand<By>::value>>
+			BHAVESH_CXX20_CONSTEXPR auto operator*(const By& by) const { return this->mul(by); }
+
+		public: /* in-place operations, written through to the viewed matrix; only for views of mutable elements */
+			template <typename By, typename X = T, typename = std::enable_if_t<!std::is_const<X>::value>>
+			BHAVESH_CXX20_CONSTEXPR const Derived& add_eq(const By& oth) const {
+				if (oth.shape() != shape()) throw std::invalid_argument("Addition of matrices requires same shape");
+				view_detail::zip_inplace<simd_detail::elementwise_op::add>(self(), oth, std::plus<>{});
+				return self();
+			}
+			template <typename By, typename X = T, typename = std::enable_if_t<!std::is_const<X>::value>>
+			BHAVESH_CXX20_CONSTEXPR const Derived& sub_eq(const By& oth) const {
+				if (oth.shape() != shape()) throw std::invalid_argument("Subtraction of matrices requires same shape");
+				view_detail::zip_inplace<simd_detail::elementwise_op::sub>(self(), oth, std::minus<>{});
+				return self();
+			}
+			template <typename By, typename X = T, typename = std::enable_if_t<!std::is_const<X>::value && !is_matrix<By>::value && !is_matrix_view<By>::value>>
+			BHAVESH_CXX20_CONSTEXPR const Derived& mul_eq(const By& oth) const {
+				view_detail::for_each_blocked(m, n, [this, &oth](std::size_t i, std::size_t j) { _get(i, j) = static_cast<value_type>(std::move(_get(i, j)) * oth); });
+				return self();
+			}
+			// copies src (a matrix or a view of the same shape) into the viewed elements
+			template <typename By, typename X = T, typename = std::enable_if_t<!std::is_const<X>::value>>
+			BHAVESH_CXX20_CONSTEXPR const Derived& assign(const By& src) const {
+				if (src.shape() != shape()) throw std::invalid_argument("Assignment of matrices requires same shape");
+				view_detail::for_each_blocked(m, n, [this, &src](std::size_t i, std::size_t j) { _get(i, j) = static_cast<value_type>(src._get(i, j)); });
+				return self();
+			}
+			template <typename X = T, typename = std::enable_if_t<!std::is_const<X>::value>>
+			BHAVESH_CXX20_CONSTEXPR const Derived& fill(const value_type& value) const {
+				view_detail::for_each_blocked(m, n, [this, &value](std::size_t i, std::size_t j) { _get(i, j) = value; });
+				return self();
+			}
+
+			template <typename By>
+			BHAVESH_CXX20_CONSTEXPR const Derived& operator+=(const By& by) const { return this->add_eq(by); }
+			template <typename By>
+			BHAVESH_CXX20_CONSTEXPR const Derived& operator-=(const By& by) const { return this->sub_eq(by); }
+			template <typename By>
+			BHAVESH_CXX20_CONSTEXPR const Derived& operator*=(const By& by) const { return this->mul_eq(by); }
+
+		public: /* comparison */
+			template <typename Oth, typename OthAlloc>
+			BHAVESH_CXX20_CONSTEXPR bool operator==(const matrix<Oth, OthAlloc>& oth) const { return view_detail::equal(*this, oth); }
+			template <typename Oth, typename OthAlloc>
+			BHAVESH_CXX20_CONSTEXPR bool operator!=(const matrix<Oth, OthAlloc>& oth) const { return !view_detail::equal(*this, oth); }
+			template <typename V, typename Oth>
+			BHAVESH_CXX20_CONSTEXPR bool operator==(const view_base<V, Oth>& oth) const { return view_detail::equal(*this, oth); }
+			template <typename V, typename Oth>
+			BHAVESH_CXX20_CONSTEXPR bool operator!=(const view_base<V, Oth>& oth) const { return !view_detail::equal(*this, oth); }
+
+		protected:
+			BHAVESH_CXX20_CONSTEXPR const Derived& self() const noexcept { return static_cast<const Derived&>(*this); }
+
+			T* m_data;
+			std::size_t m;
+			std::size_t n;
+			std::ptrdiff_t rs;
+			std::ptrdiff_t cs;
+		};
+	}
+	}
+
+	/*
+	 * non-owning, lazily transposed look at a matrix; for a whole m x n matrix that is the n x m view with strides (1, n)
+	 * mul hands those strides to the gemm as a layout, and add/sub/== read through them tile by tile, so the transpose is
+	 * never materialized (call to_matrix() when a copy is wanted)
+	 */
+	template <typename T>
+	class transposed_view : public view_detail::view_base<transposed_view<T>, T> {
+		using base = view_detail::view_base<transposed_view<T>, T>;
+	public:
+		using typename base::value_type;
+
+		BHAVESH_CXX20_CONSTEXPR transposed_view(T* data, std::size_t m, std::size_t n, std::ptrdiff_t rs, std::ptrdiff_t cs) noexcept
+			: base(data, m, n, rs, cs) {}
+		template <typename Alloc, typename X = T, typename = std::enable_if_t<!std::is_const<X>::value>>
+		BHAVESH_CXX20_CONSTEXPR explicit transposed_view(matrix<value_type, Alloc>& mat) noexcept
+			: transposed_view(mat.data(), mat.shape().second, mat.shape().first, 1, static_cast<std::ptrdiff_t>(mat.shape().second)) {}
+		template <typename Alloc, typename X = T, typename = std::enable_if_t<std::is_const<X>::value>>
+		BHAVESH_CXX20_CONSTEXPR explicit transposed_view(const matrix<value_type, Alloc>& mat) noexcept
+			: transposed_view(mat.data(), mat.shape().second, mat.shape().first, 1, static_cast<std::ptrdiff_t>(mat.shape().second)) {}
+
+		template <typename X = T, typename = std::enable_if_t<!std::is_const<X>::value>>
+		BHAVESH_CXX20_CONSTEXPR operator transposed_view<const T>() const noexcept {
+			return transposed_view<const T>(this->m_data, this->m, this->n, this->rs, this->cs);
+		}
+	};
+
+	/*
+	 * zero-copy rows x cols window into a row-major matrix: row i starts ld elements after row i - 1
+	 * returned by matrix::block(r0, c0, rows, cols); blocks of blocks and transposed blocks are views again, so block-wise
+	 * algorithms can work tile by tile without copying a tile out (call to_matrix() when a copy is wanted)
+	 */
+	template <typename T>
+	class matrix_view : public view_detail::view_base<matrix_view<T>, T> {
+		using base = view_detail::view_base<matrix_view<T>, T>;
+	public:
+		using typename base::value_type;
+
+		BHAVESH_CXX20_CONSTEXPR matrix_view(T* data, std::size_t rows, std::size_t cols, std::size_t ld) noexcept
+			: base(data, rows, cols, static_cast<std::ptrdiff_t>(ld), 1) {}
+		template <typename Alloc, typename X = T, typename = std::enable_if_t<!std::is_const<X>::value>>
+		BHAVESH_CXX20_CONSTEXPR explicit matrix_view(matrix<value_type, Alloc>& mat) noexcept
+			: matrix_view(mat.data(), mat.shape().first, mat.shape().second, mat.shape().second) {}
+		template <typename Alloc, typename X = T, typename = std::enable_if_t<std::is_const<X>::value>>
+		BHAVESH_CXX20_CONSTEXPR explicit matrix_view(const matrix<value_type, Alloc>& mat) noexcept
+			: matrix_view(mat.data(), mat.shape().first, mat.shape().second, mat.shape().second) {}
+
+		template <typename X = T, typename = std::enable_if_t<!std::is_const<X>::value>>
+		BHAVESH_CXX20_CONSTEXPR operator matrix_view<const T>() const noexcept {
+			return matrix_view<const T>(this->m_data, this->m, this->n, ld());
+		}
+
+		BHAVESH_CXX20_CONSTEXPR std::size_t ld() const noexcept { return static_cast<std::size_t>(this->rs); }
+
+		BHAVESH_CXX20_CONSTEXPR matrix_row<T> operator[](std::size_t i) const {
+#			if BHAVESH_DEBUG
+				if (i >= this->m) throw std::out_of_range("Out of range element access attempted for matrix[i][j]");
+#			endif
+			return matrix_row<T>(this->m, this->n, this->m_data + i * ld());
+		}
+		BHAVESH_CXX20_CONSTEXPR matrix_column<T> column(std::size_t j) const {
+			if (j >= this->n) throw std::out_of_range("Out of range column requested from matrix");
+			return matrix_column<T>(this->m, ld(), this->m_data + j);
+		}
+
+		BHAVESH_CXX20_CONSTEXPR matrix_view block(std::size_t r0, std::size_t c0, std::size_t rows, std::size_t cols) const {
+			if (r0 > this->m || c0 > this->n || rows > this->m - r0 || cols > this->n - c0) throw std::out_of_range("Out of range block requested from matrix");
+			return matrix_view(this->m_data + r0 * ld() + c0, rows, cols, ld());
+		}
+		BHAVESH_CXX20_CONSTEXPR transposed_view<T> transposed() const noexcept {
+			return transposed_view<T>(this->m_data, this->n, this->m, 1, this->rs);
+		}
 	};
+
+	inline namespace detail {
+	namespace product_detail {
+		// [lowest, one past highest) address an operand can touch; empty operands touch nothing
+		template <typename X>
+		std::pair<const void*, const void*> footprint(const X& x) {
+			const auto s = view_detail::strides(x);
+			if (x.shape().first == 0 || x.shape().second == 0) return { nullptr, nullptr };
+			const auto* lo = x.data();
+			const auto* hi = x.data();
+			const std::ptrdiff_t dr = static_cast<std::ptrdiff_t>(x.shape().first - 1) * s.first, dc = static_cast<std::ptrdiff_t>(x.shape().second - 1) * s.second;
+			(dr < 0 ? lo : hi) += dr;
+			(dc < 0 ? lo : hi) += dc;
+			return { lo, hi + 1 };
+		}
+		template <typename X, typename Y>
+		bool overlap(const X& x, const Y& y) {
+			const auto fx = footprint(x), fy = footprint(y);
+			return fx.first && fy.first && std::less<const void*>{}(fx.first, fy.second) && std::less<const void*>{}(fy.first, fx.second);
+		}
+
+		// c = alpha * a * b + beta * c, c a matrix or a mutable view; beta == 0 never reads c
+		template <typename C, typename A, typename B, typename TC = std::remove_cv_t<typename C::value_type>>
+		void multiply_accumulate(C& c, const TC& alpha, const A& a, const TC& beta, const B& b) {
+			if (a.shape().second != b.shape().first || c.shape().first != a.shape().first || c.shape().second != b.shape().second) {
+				throw std::invalid_argument("Invalid shapes for multiplication of matrices");
+			}
+			const std::size_t m = c.shape().first, n = c.shape().second, k = a.shape().second;
+			if (overlap(c, a) || overlap(c, b)) { // c is also an input: form the product first
+				matrix<TC> p(m, n, uninitialized);
+				multiply_accumulate(p, alpha, a, TC{}, b);
+				view_detail::for_each_blocked(m, n, [&c, &p, &beta](std::size_t i, std::size_t j) {
+					c._get(i, j) = beta == TC{} ? p._get(i, j) : static_cast<TC>(p._get(i, j) + beta * c._get(i, j));
+				});
+				return;
+			}
+
+			using TA = std::remove_cv_t<typename A::value_type>;
+			using TB = std::remove_cv_t<typename B::value_type>;
+			if constexpr (gemm_detail::use_blocked_gemm<TA, TB, TC>::value) {
+				const auto sa = view_detail::strides(a), sb = view_detail::strides(b), sc = view_detail::strides(c);
+				if (n == 1) gemv_detail::gemv<TC>(m, k, alpha, a.data(), sa.first, sa.second, b.data(), sb.first, beta, c.data(), sc.first);
+				else if (m == 1) gemv_detail::gemv<TC>(n, k, alpha, b.data(), sb.second, sb.first, a.data(), sa.second, beta, c.data(), sc.second);
+				else gemm_detail::parallel_gemm<TC>(m, n, k, alpha, a.data(), sa.first, sa.second, b.data(), sb.first, sb.second, beta, c.data(), sc.first, sc.second);
+			}
+			else {
+				for (std::size_t i = 0; i != m; ++i) {
+					for (std::size_t j = 0; j != n; ++j) {
+						TC sum{};
+						for (std::size_t p = 0; p != k; ++p) sum = sum + a._get(i, p) * b._get(p, j);
+						c._get(i, j) = beta == TC{} ? static_cast<TC>(alpha * sum) : static_cast<TC>(alpha * sum + beta * c._get(i, j));
+					}
+				}
+			}
+		}
+	}
+	}
+
+	/*
+	 * C = alpha * A * B + beta * C, written straight into C (a matrix, or a mutable matrix_view such as a block): no temporaries,
+	 * no second pass; the product is the blocked gemm with alpha and beta folded into its epilogue, split over matrix_scheduler's pool
+	 * A and B may be matrices or views (transposed ones included); beta == 0 never reads C, and a C that overlaps A or B is handled
+	 */
+	template <typename C, typename A, typename B, typename = std::enable_if_t<(is_matrix<std::decay_t<C>>::value || is_matrix_view<std::decay_t<C>>::value) &&
+		(is_matrix<A>::value || is_matrix_view<A>::value) && (is_matrix<B>::value || is_matrix_view<B>::value)>>
+	void multiply_accumulate(C&& c, const typename std::decay_t<C>::value_type& alpha, const A& a, const typename std::decay_t<C>::value_type& beta, const B& b) {
+		static_assert(!std::is_const<std::remove_pointer_t<decltype(c.data())>>::value, "multiply_accumulate writes into C");
+		product_detail::multiply_accumulate(c, alpha, a, beta, b);
+	}
+
+	// out = A * B reusing out's storage; only a change of shape allocates, so a steady state loop allocates nothing
+	template <typename T, typename Alloc, typename A, typename B, typename = std::enable_if_t<(is_matrix<A>::value || is_matrix_view<A>::value) && (is_matrix<B>::value || is_matrix_view<B>::value)>>
+	matrix<T, Alloc>& mul_into(matrix<T, Alloc>& out, const A& a, const B& b) {
+		if (a.shape().second != b.shape().first) throw std::invalid_argument("Invalid shapes for multiplication of matrices");
+		if (out.shape() != std::make_pair(a.shape().first, b.shape().second)) {
+			matrix<T, Alloc> fresh(a.shape().first, b.shape().second, uninitialized);
+			if (product_detail::overlap(out, a) || product_detail::overlap(out, b)) { // resizing first would destroy an input
+				product_detail::multiply_accumulate(fresh, T(1), a, T(0), b);
+				return out = std::move(fresh);
+			}
+			out = std::move(fresh);
+		}
+		product_detail::multiply_accumulate(out, T(1), a, T(0), b);
+		return out;
+	}
+
+	// entry point into lazy evaluation: lazy(A) + B - C * 2.0 is only computed once it is assigned to a matrix (or .eval() is called)
+	template <typename T, typename Alloc>
+	BHAVESH_CXX20_CONSTEXPR expression_detail::terminal<T> lazy(const matrix<T, Alloc>& mat) {
+		return expression_detail::operand<matrix<T, Alloc>>::get(mat);
+	}
+	// the expression only points into mat, so a temporary would be gone before it is evaluated; name the matrix first
+	template <typename T, typename Alloc>
+	void lazy(const matrix<T, Alloc>&&) = delete;
 		
 }
 
+#include "bhavesh_matrix_linalg.h" // matrix::solve, inverse, determinant
+#include "bhavesh_matrix_vector.h" // dense_vector, matrix * vector
+#include "bhavesh_matrix_reduce.h" // sum, min / max, norms, row / column sums
+#include "bhavesh_matrix_map.h" // map / zip with user functors, broadcasting
+
 #endif // !BHAVESH_MATRIX_H
\ No newline at end of file
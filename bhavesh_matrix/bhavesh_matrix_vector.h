@@ -0,0 +1,240 @@
+#ifndef BHAVESH_MATRIX_VECTOR_H
+#define BHAVESH_MATRIX_VECTOR_H 0.1
+
+#include "bhavesh_matrix_v1.h"
+
+namespace bhavesh {
+
+	inline namespace detail {
+	namespace vector_detail {
+		template <typename V>
+		using element_t = std::remove_cv_t<std::remove_pointer_t<decltype(std::declval<const V&>().data())>>;
+
+		// [lowest, one past highest) address a vector operand, matrix or view can touch (unit or positive strides)
+		template <typename V, std::enable_if_t<is_vector_operand<V>::value, int> = 0>
+		std::pair<const void*, const void*> footprint(const V& v) {
+			if (v.size() == 0) return { nullptr, nullptr };
+			return { v.data(), v.data() + static_cast<std::ptrdiff_t>(v.size() - 1) * stride(v) + 1 };
+		}
+		template <typename X, std::enable_if_t<!is_vector_operand<X>::value, int> = 0>
+		std::pair<const void*, const void*> footprint(const X& x) { return product_detail::footprint(x); }
+
+		template <typename V, typename X>
+		bool overlap(const V& v, const X& x) {
+			const auto fv = footprint(v), fx = footprint(x);
+			return fv.first && fx.first && std::less<const void*>{}(fv.first, fx.second) && std::less<const void*>{}(fx.first, fv.second);
+		}
+
+		struct adopt_t {};
+
+		// y = alpha * op(A) x + beta * y, op(A) = A or A^T; A a matrix or view, x a vector operand, y strided storage of the right extent
+		template <bool transposed, typename TY, typename A, typename X>
+		void gemv(const TY& alpha, const A& a, const X& x, const TY& beta, TY* y, std::ptrdiff_t incy) {
+			const std::size_t m = transposed ? a.shape().second : a.shape().first, k = transposed ? a.shape().first : a.shape().second;
+			if (x.size() != k) throw std::invalid_argument("Invalid shapes for matrix-vector product");
+			const auto s = view_detail::strides(a);
+			const std::ptrdiff_t rs = transposed ? s.second : s.first, cs = transposed ? s.first : s.second, incx = stride(x);
+			using TA = std::remove_cv_t<typename A::value_type>;
+			if constexpr (gemm_detail::use_blocked_gemm<TA, element_t<X>, TY>::value) {
+				gemv_detail::gemv<TY>(m, k, alpha, a.data(), rs, cs, x.data(), incx, beta, y, incy);
+			}
+			else {
+				const auto* pa = a.data();
+				const auto* px = x.data();
+				for (std::size_t i = 0; i != m; ++i) {
+					TY sum{};
+					for (std::size_t p = 0; p != k; ++p) sum = sum + pa[static_cast<std::ptrdiff_t>(i) * rs + static_cast<std::ptrdiff_t>(p) * cs] * px[static_cast<std::ptrdiff_t>(p) * incx];
+					TY& yi = y[static_cast<std::ptrdiff_t>(i) * incy];
+					yi = beta == TY{} ? static_cast<TY>(alpha * sum) : static_cast<TY>(alpha * sum + beta * yi);
+				}
+			}
+		}
+
+		// y = alpha * op(A) x + beta * y into a vector operand y that may share storage with A or x
+		template <bool transposed, typename A, typename X, typename Y>
+		void gemv_into(const element_t<Y>& alpha, const A& a, const X& x, const element_t<Y>& beta, Y& y) {
+			using TY = element_t<Y>;
+			if (y.size() != (transposed ? a.shape().second : a.shape().first)) throw std::invalid_argument("Invalid shapes for matrix-vector product");
+			if (overlap(y, a) || overlap(y, x)) { // y is also an input: form the product first
+				dense_vector<TY> p(y.size(), uninitialized);
+				gemv<transposed>(TY(1), a, x, TY{}, p.data(), 1);
+				for (std::size_t i = 0; i != y.size(); ++i) {
+					TY& yi = y.data()[static_cast<std::ptrdiff_t>(i) * stride(y)];
+					yi = beta == TY{} ? static_cast<TY>(alpha * p[i]) : static_cast<TY>(alpha * p[i] + beta * yi);
+				}
+				return;
+			}
+			gemv<transposed>(alpha, a, x, beta, y.data(), stride(y));
+		}
+
+		template <typename A, typename X>
+		using product_t = matrix_detail::multiplication_t<const std::remove_cv_t<typename A::value_type>&, const element_t<X>&>;
+
+		template <typename A, typename X>
+		using enable_if_gemv = std::enable_if_t<(is_matrix<A>::value || is_matrix_view<A>::value) && is_vector_operand<X>::value>;
+	}
+	}
+
+	/*
+	 * owning, contiguous vector of n elements; underneath it is an n x 1 matrix, so it shares the matrix allocators, the small buffer and
+	 * the simd elementwise kernels. A * x and x * A (that is A^T x) go through the gemv kernels, which also take matrix_row and
+	 * matrix_column views directly, so a product with a row or column of a matrix needs no copy; see gemv / gemv_t below for
+	 * the accumulating forms that write into an existing vector
+	 */
+	template <typename T, typename Alloc>
+	class dense_vector {
+	public:
+		using value_type = T;
+		using element_type = T;
+		using iterator = T*;
+		using const_iterator = const T*;
+
+		BHAVESH_CXX20_CONSTEXPR dense_vector() = default;
+		// n value-initialized elements
+		BHAVESH_CXX20_CONSTEXPR explicit dense_vector(std::size_t n) : m_data(n, 1) {}
+		BHAVESH_CXX20_CONSTEXPR dense_vector(std::size_t n, matrix_detail::uninitialized_t) : m_data(n, 1, uninitialized) {}
+		BHAVESH_CXX20_CONSTEXPR dense_vector(std::size_t n, const T& value) : m_data(n, 1, value) {}
+		BHAVESH_CXX20_CONSTEXPR dense_vector(std::initializer_list<T> il) : m_data(il.size(), 1, il) {}
+		// a copy of a row or column of a matrix, or of another vector
+		template <typename V, typename = std::enable_if_t<is_vector_operand<V>::value>>
+		BHAVESH_CXX20_CONSTEXPR explicit dense_vector(const V& v) : m_data(v.size(), 1) {
+			for (std::size_t i = 0; i != v.size(); ++i) m_data(i) = static_cast<T>(v[i]);
+		}
+
+	public: /* accessors */
+		BHAVESH_CXX20_CONSTEXPR std::size_t size() const noexcept { return m_data.shape().first; }
+		BHAVESH_CXX20_CONSTEXPR bool empty() const noexcept { return size() == 0; }
+		BHAVESH_CXX20_CONSTEXPR       T* data()       noexcept { return m_data.data(); }
+		BHAVESH_CXX20_CONSTEXPR const T* data() const noexcept { return m_data.data(); }
+
+		BHAVESH_CXX20_CONSTEXPR       T& operator[](std::size_t i)       { return m_data(i); }
+		BHAVESH_CXX20_CONSTEXPR const T& operator[](std::size_t i) const { return m_data(i); }
+		BHAVESH_CXX20_CONSTEXPR T& get(std::size_t i) {
+			if (i >= size()) throw std::out_of_range("Out of range element access attempted for vector[i]");
+			return m_data(i);
+		}
+		BHAVESH_CXX20_CONSTEXPR const T& get(std::size_t i) const {
+			if (i >= size()) throw std::out_of_range("Out of range element access attempted for vector[i]");
+			return m_data(i);
+		}
+
+		BHAVESH_CXX20_CONSTEXPR       iterator  begin()       noexcept { return data(); }
+		BHAVESH_CXX20_CONSTEXPR const_iterator  begin() const noexcept { return data(); }
+		BHAVESH_CXX20_CONSTEXPR const_iterator cbegin() const noexcept { return data(); }
+		BHAVESH_CXX20_CONSTEXPR       iterator    end()       noexcept { return data() + size(); }
+		BHAVESH_CXX20_CONSTEXPR const_iterator    end() const noexcept { return data() + size(); }
+		BHAVESH_CXX20_CONSTEXPR const_iterator   cend() const noexcept { return data() + size(); }
+
+		// the n x 1 matrix holding the elements, and n x 1 / 1 x n views of them for mixing with matrix arithmetic
+		BHAVESH_CXX20_CONSTEXPR const matrix<T, Alloc>& as_matrix() const noexcept { return m_data; }
+		BHAVESH_CXX20_CONSTEXPR matrix_view<T> as_column() noexcept { return matrix_view<T>(data(), size(), 1, 1); }
+		BHAVESH_CXX20_CONSTEXPR matrix_view<const T> as_column() const noexcept { return matrix_view<const T>(data(), size(), 1, 1); }
+		BHAVESH_CXX20_CONSTEXPR matrix_view<T> as_row() noexcept { return matrix_view<T>(data(), 1, size(), size()); }
+		BHAVESH_CXX20_CONSTEXPR matrix_view<const T> as_row() const noexcept { return matrix_view<const T>(data(), 1, size(), size()); }
+
+	public: /* elementwise arithmetic, through the matrix kernels */
+		template <typename By, typename ByAlloc, typename To = matrix_detail::addition_t<const T&, const By&>>
+		BHAVESH_CXX20_CONSTEXPR dense_vector<To, Alloc> add(const dense_vector<By, ByAlloc>& oth) const {
+			return dense_vector<To, Alloc>(adopt, m_data.add(oth.m_data));
+		}
+		template <typename By, typename ByAlloc, typename To = matrix_detail::subtraction_t<const T&, const By&>>
+		BHAVESH_CXX20_CONSTEXPR dense_vector<To, Alloc> sub(const dense_vector<By, ByAlloc>& oth) const {
+			return dense_vector<To, Alloc>(adopt, m_data.sub(oth.m_data));
+		}
+		template <typename By, typename To = matrix_detail::multiplication_t<const T&, const By&>, typename = std::enable_if_t<!is_matrix<By>::value && !is_matrix_view<By>::value && !is_vector_operand<By>::value>>
+		BHAVESH_CXX20_CONSTEXPR dense_vector<To, Alloc> mul(const By& scalar) const {
+			return dense_vector<To, Alloc>(adopt, m_data.mul(scalar));
+		}
+		template <typename By, typename ByAlloc>
+		BHAVESH_CXX20_CONSTEXPR dense_vector& add_eq(const dense_vector<By, ByAlloc>& oth) { m_data.add_eq(oth.m_data); return *this; }
+		template <typename By, typename ByAlloc>
+		BHAVESH_CXX20_CONSTEXPR dense_vector& sub_eq(const dense_vector<By, ByAlloc>& oth) { m_data.sub_eq(oth.m_data); return *this; }
+		template <typename By, typename = std::enable_if_t<!is_matrix<By>::value && !is_matrix_view<By>::value && !is_vector_operand<By>::value>>
+		BHAVESH_CXX20_CONSTEXPR dense_vector& mul_eq(const By& scalar) { m_data.mul_eq(scalar); return *this; }
+
+		template <typename By, typename ByAlloc>
+		BHAVESH_CXX20_CONSTEXPR auto operator+(const dense_vector<By, ByAlloc>& oth) const { return add(oth); }
+		template <typename By, typename ByAlloc>
+		BHAVESH_CXX20_CONSTEXPR auto operator-(const dense_vector<By, ByAlloc>& oth) const { return sub(oth); }
+		template <typename By, typename = std::enable_if_t<!is_matrix<By>::value && !is_matrix_view<By>::value && !is_vector_operand<By>::value && !is_sparse_matrix<By>::value>>
+		BHAVESH_CXX20_CONSTEXPR auto operator*(const By& scalar) const { return mul(scalar); }
+		template <typename By, typename ByAlloc>
+		BHAVESH_CXX20_CONSTEXPR dense_vector& operator+=(const dense_vector<By, ByAlloc>& oth) { return add_eq(oth); }
+		template <typename By, typename ByAlloc>
+		BHAVESH_CXX20_CONSTEXPR dense_vector& operator-=(const dense_vector<By, ByAlloc>& oth) { return sub_eq(oth); }
+		template <typename By>
+		BHAVESH_CXX20_CONSTEXPR dense_vector& operator*=(const By& scalar) { return mul_eq(scalar); }
+
+	public: /* comparisons */
+		template <typename Oth, typename OthAlloc>
+		BHAVESH_CXX20_CONSTEXPR bool operator==(const dense_vector<Oth, OthAlloc>& oth) const { return m_data == oth.m_data; }
+		template <typename Oth, typename OthAlloc>
+		BHAVESH_CXX20_CONSTEXPR bool operator!=(const dense_vector<Oth, OthAlloc>& oth) const { return !(m_data == oth.m_data); }
+
+	private:
+		template <typename, typename> friend class dense_vector;
+
+		static constexpr vector_detail::adopt_t adopt{};
+		BHAVESH_CXX20_CONSTEXPR dense_vector(vector_detail::adopt_t, matrix<T, Alloc>&& column) : m_data(std::move(column)) {}
+
+		matrix<T, Alloc> m_data; // size() x 1
+	};
+
+	/* matrix-vector products; A is a matrix or a view (transposed ones included), x a dense_vector, matrix_row or matrix_column */
+
+	// A x
+	template <typename A, typename X, typename To = vector_detail::product_t<A, X>, typename = vector_detail::enable_if_gemv<A, X>>
+	dense_vector<To> gemv(const A& a, const X& x) {
+		dense_vector<To> y(a.shape().first, uninitialized);
+		vector_detail::gemv<false>(To(1), a, x, To{}, y.data(), 1);
+		return y;
+	}
+
+	// A^T x (the row vector x^T A, as a column)
+	template <typename A, typename X, typename To = vector_detail::product_t<A, X>, typename = vector_detail::enable_if_gemv<A, X>>
+	dense_vector<To> gemv_t(const A& a, const X& x) {
+		dense_vector<To> y(a.shape().second, uninitialized);
+		vector_detail::gemv<true>(To(1), a, x, To{}, y.data(), 1);
+		return y;
+	}
+
+	// y = alpha * A x + beta * y written into y: a dense_vector, or a row or column of a mutable matrix; beta == 0 never reads y,
+	// and a y sharing storage with A or x is handled
+	template <typename A, typename X, typename Y, typename = vector_detail::enable_if_gemv<A, X>, typename = std::enable_if_t<is_vector_operand<std::decay_t<Y>>::value>>
+	void gemv(const vector_detail::element_t<std::decay_t<Y>>& alpha, const A& a, const X& x, const vector_detail::element_t<std::decay_t<Y>>& beta, Y&& y) {
+		static_assert(!std::is_const<std::remove_pointer_t<decltype(y.data())>>::value, "gemv writes into y");
+		vector_detail::gemv_into<false>(alpha, a, x, beta, y);
+	}
+
+	// y = alpha * A^T x + beta * y, as above
+	template <typename A, typename X, typename Y, typename = vector_detail::enable_if_gemv<A, X>, typename = std::enable_if_t<is_vector_operand<std::decay_t<Y>>::value>>
+	void gemv_t(const vector_detail::element_t<std::decay_t<Y>>& alpha, const A& a, const X& x, const vector_detail::element_t<std::decay_t<Y>>& beta, Y&& y) {
+		static_assert(!std::is_const<std::remove_pointer_t<decltype(y.data())>>::value, "gemv_t writes into y");
+		vector_detail::gemv_into<true>(alpha, a, x, beta, y);
+	}
+
+	template <typename A, typename X, typename = vector_detail::enable_if_gemv<A, X>>
+	dense_vector<vector_detail::product_t<A, X>> operator*(const A& a, const X& x) { return gemv(a, x); }
+
+	template <typename X, typename A, typename = vector_detail::enable_if_gemv<A, X>>
+	dense_vector<vector_detail::product_t<A, X>> operator*(const X& x, const A& a) { return gemv_t(a, x); }
+
+	// x . y for any two vector operands of the same size
+	template <typename X, typename Y, typename To = matrix_detail::multiplication_t<const vector_detail::element_t<X>&, const vector_detail::element_t<Y>&>,
+		typename = std::enable_if_t<is_vector_operand<X>::value && is_vector_operand<Y>::value>>
+	To dot(const X& x, const Y& y) {
+		if (x.size() != y.size()) throw std::invalid_argument("Dot product requires same size");
+		if constexpr (gemm_detail::use_blocked_gemm<vector_detail::element_t<X>, vector_detail::element_t<Y>, To>::value) {
+			if (vector_detail::stride(x) == 1 && vector_detail::stride(y) == 1) return gemv_detail::dot<To>(x.size(), x.data(), y.data());
+		}
+		To sum{};
+		for (std::size_t i = 0; i != x.size(); ++i) sum = sum + x.data()[static_cast<std::ptrdiff_t>(i) * vector_detail::stride(x)] * y.data()[static_cast<std::ptrdiff_t>(i) * vector_detail::stride(y)];
+		return sum;
+	}
+
+	template <typename S, typename T, typename Alloc, typename = std::enable_if_t<!is_matrix<S>::value && !is_matrix_view<S>::value && !is_vector_operand<S>::value>>
+	BHAVESH_CXX20_CONSTEXPR auto operator*(const S& scalar, const dense_vector<T, Alloc>& v) { return v.mul(scalar); } // scalar multiplication is assumed to commute
+
+}
+
+#endif // !BHAVESH_MATRIX_VECTOR_H